@@ -0,0 +1,51 @@
+#include "cache.hpp"
+
+#include "transformation.hpp"
+
+namespace color {
+
+// No rgb888_t color has bits above the low 24 set, so this key never matches a lookup.
+static const rgb888_t kEmptyKey = 0xffffffff;
+
+ConversionCache::ConversionCache(ColorSpace space, std::size_t capacity)
+    : space_(space), shift_(32), hits_(0), misses_(0) {
+  std::size_t size = 1;
+  while (size < capacity && shift_ > 8) {
+    size <<= 1;
+    shift_--;
+  }
+  entries_.resize(size);
+  clear();
+}
+
+void ConversionCache::convert(rgb888_t rgb888, float output[3]) {
+  rgb888 &= 0xffffff;
+  // Fibonacci hashing spreads runs of similar colors across the whole table.
+  // References:
+  //  https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
+  const uint32_t hash = uint32_t(rgb888 * 2654435769u);
+  Entry& entry = entries_[(shift_ == 32) ? 0 : (hash >> shift_)];
+  if (entry.key == rgb888) {
+    hits_++;
+  } else {
+    misses_++;
+    entry.key = rgb888;
+    to_space(to_srgb(rgb888), space_, entry.values);
+  }
+  for (int i = 0; i < 3; i++) {
+    output[i] = entry.values[i];
+  }
+}
+
+void ConversionCache::reset_statistics() {
+  hits_ = 0;
+  misses_ = 0;
+}
+
+void ConversionCache::clear() {
+  for (Entry& entry : entries_) {
+    entry.key = kEmptyKey;
+  }
+}
+
+} // namespace color
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "space.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace color {
+
+// A bounded cache of rgb888_t colors converted into a target color space.
+//
+// The cache is direct mapped with a fixed number of entries, so repeated colors cost a hash and a
+// compare while the memory footprint stays constant. It is not synchronized; give each thread its
+// own instance.
+class ConversionCache {
+public:
+  // The capacity is rounded up to a power of two.
+  explicit ConversionCache(ColorSpace space, std::size_t capacity = 4096);
+
+  ColorSpace space() const { return space_; }
+  std::size_t capacity() const { return entries_.size(); }
+
+  // Convert a color into the three components of the cache's space.
+  void convert(rgb888_t rgb888, float output[3]);
+
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+  void reset_statistics();
+
+  // Forget every cached color.
+  void clear();
+
+private:
+  struct Entry {
+    rgb888_t key;
+    float values[3];
+  };
+
+  ColorSpace space_;
+  int shift_;
+  std::vector<Entry> entries_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+} // namespace color
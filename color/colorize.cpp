@@ -0,0 +1,122 @@
+#include "colorize.hpp"
+
+#include "internal/math.hpp"
+#include "internal/parallel.hpp"
+#include "interpolation.hpp"
+#include "transformation.hpp"
+
+#include <vector>
+
+namespace color {
+
+using InterpolationFunction = sRgb (*)(PaletteView, float);
+
+static InterpolationFunction interpolation_function(Interpolation mode) {
+  switch (mode) {
+  case Interpolation::NearestNeighbor:
+    return interpolate_nearest_neighbor;
+  case Interpolation::Linear:
+    return interpolate_linear;
+  case Interpolation::HsvLinear:
+    return interpolate_hsv_linear;
+  case Interpolation::HslLinear:
+    return interpolate_hsl_linear;
+  case Interpolation::XyzLinear:
+    return interpolate_xyz_linear;
+  case Interpolation::LabLinear:
+    return interpolate_lab_linear;
+  }
+  return interpolate_linear;
+}
+
+// Find the smallest and largest finite values of the field, or an empty range if there are none.
+// Infinities are left out so they cannot stretch the range until every finite value shares a color.
+static ColorizeRange find_range(const float* field, std::size_t count,
+                                const ColorizeOptions& options) {
+  struct ChunkRange {
+    float min, max;
+    bool found;
+  };
+
+  const std::size_t chunks =
+      internal::parallel_chunk_count(count, internal::kMinParallelChunk, options.threads);
+  std::vector<ChunkRange> ranges(chunks, ChunkRange{0.0f, 0.0f, false});
+  internal::parallel_for_chunks(count, chunks, [&](std::size_t chunk, std::size_t begin,
+                                                   std::size_t end) {
+    ChunkRange range{0.0f, 0.0f, false};
+    for (std::size_t i = begin; i < end; i++) {
+      const float value = field[i * options.stride];
+      if (!internal::isfinitef(value)) {
+        continue;
+      }
+      range.min = (!range.found || value < range.min) ? value : range.min;
+      range.max = (!range.found || value > range.max) ? value : range.max;
+      range.found = true;
+    }
+    ranges[chunk] = range;
+  });
+
+  ChunkRange merged{0.0f, 0.0f, false};
+  for (const ChunkRange& range : ranges) {
+    if (range.found) {
+      merged.min = merged.found ? internal::min(merged.min, range.min) : range.min;
+      merged.max = merged.found ? internal::max(merged.max, range.max) : range.max;
+      merged.found = true;
+    }
+  }
+  return ColorizeRange{merged.min, merged.max, false};
+}
+
+ColorizeRange colorize(const float* field, std::size_t count, ColorizeRange range,
+                       PaletteView palette, Interpolation mode, rgba8888_t* output,
+                       const ColorizeOptions& options) {
+  if (range.automatic) {
+    range = find_range(field, count, options);
+  }
+
+  const std::size_t table_size = internal::max(options.table_size, std::size_t(2));
+  std::vector<rgba8888_t> table(table_size);
+  const InterpolationFunction interpolate = interpolation_function(mode);
+  for (std::size_t i = 0; i < table_size; i++) {
+    table[i] = to_rgba8888(interpolate(palette, float(i) / float(table_size - 1)));
+  }
+
+  const float last = float(table_size - 1);
+  const float extent = range.max - range.min;
+  const float scale = (extent > 0.0f) ? last / extent : 0.0f;
+  const rgba8888_t below = options.clamp ? table.front() : options.below_color;
+  const rgba8888_t above = options.clamp ? table.back() : options.above_color;
+  const rgba8888_t nan = options.nan_color;
+  const float min = range.min;
+  const float max = range.max;
+  const std::size_t stride = options.stride;
+  const rgba8888_t* lookup = table.data();
+
+  const std::size_t chunks =
+      internal::parallel_chunk_count(count, internal::kMinParallelChunk, options.threads);
+  internal::parallel_for_chunks(count, chunks, [=](std::size_t, std::size_t begin,
+                                                   std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      const float value = field[i * stride];
+      rgba8888_t color;
+      // NaN is the only value unequal to itself, which keeps the check inline in this loop.
+      if (value != value) {
+        color = nan;
+      } else if (value < min) {
+        color = below;
+      } else if (value > max) {
+        color = above;
+      } else {
+        // Offset from min before scaling so a narrow range far from zero keeps its precision. The
+        // index is still clamped since rounding can land past the end, and an infinite range bound
+        // gives NaN, which fails the comparison and takes the last entry.
+        const float indexf = (value - min) * scale + 0.5f;
+        color = lookup[(indexf < last) ? std::size_t(indexf) : table_size - 1];
+      }
+      output[i] = color;
+    }
+  });
+  return range;
+}
+
+} // namespace color
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "palette.hpp"
+
+#include <cstddef>
+
+namespace color {
+
+// The interpolation functions colorize can sample a palette with.
+enum class Interpolation { NearestNeighbor, Linear, HsvLinear, HslLinear, XyzLinear, LabLinear };
+
+// The field values mapped to the start and end of the palette.
+struct ColorizeRange {
+  float min;
+  float max;
+  // Ignore min and max and use the smallest and largest finite values of the field instead.
+  bool automatic;
+};
+
+// A range that is computed from the field itself.
+inline ColorizeRange automatic_range() { return ColorizeRange{0.0f, 0.0f, true}; }
+
+struct ColorizeOptions {
+  // The distance in floats between consecutive samples of the field.
+  std::size_t stride = 1;
+  // The color for NaN samples.
+  rgba8888_t nan_color = 0x00000000;
+  // When false, samples outside of the range, including infinities, use below_color and
+  // above_color rather than the color at the nearest end of the palette.
+  bool clamp = true;
+  rgba8888_t below_color = 0x00000000;
+  rgba8888_t above_color = 0x00000000;
+  // The number of palette samples in the lookup table each field value is mapped through.
+  std::size_t table_size = 4096;
+  // The number of threads to split the field across, where zero uses every hardware thread.
+  unsigned int threads = 0;
+};
+
+// Map count samples of a scalar field through a palette into RGBA8 colors, returning the range
+// used.
+//
+// The palette is sampled into a lookup table once, so the per-sample cost is a normalization and a
+// table lookup regardless of interpolation mode. An automatic range is found in a parallel pass
+// over the field before colorizing.
+ColorizeRange colorize(const float* field, std::size_t count, ColorizeRange range,
+                       PaletteView palette, Interpolation mode, rgba8888_t* output,
+                       const ColorizeOptions& options = ColorizeOptions());
+
+} // namespace color
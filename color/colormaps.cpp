@@ -0,0 +1,19 @@
+#include "colormaps.hpp"
+
+namespace color {
+
+// These are constant initialized, so no conversion happens when the library is loaded.
+extern const ColormapTable<256> kViridis256 = make_colormap<256>(kViridisStops);
+extern const ColormapTable<1024> kViridis1024 = make_colormap<1024>(kViridisStops);
+extern const ColormapTable<256> kMagma256 = make_colormap<256>(kMagmaStops);
+extern const ColormapTable<1024> kMagma1024 = make_colormap<1024>(kMagmaStops);
+extern const ColormapTable<256> kInferno256 = make_colormap<256>(kInfernoStops);
+extern const ColormapTable<1024> kInferno1024 = make_colormap<1024>(kInfernoStops);
+extern const ColormapTable<256> kPlasma256 = make_colormap<256>(kPlasmaStops);
+extern const ColormapTable<1024> kPlasma1024 = make_colormap<1024>(kPlasmaStops);
+extern const ColormapTable<256> kCividis256 = make_colormap<256>(kCividisStops);
+extern const ColormapTable<1024> kCividis1024 = make_colormap<1024>(kCividisStops);
+extern const ColormapTable<256> kTurbo256 = make_colormap<256>(kTurboStops);
+extern const ColormapTable<1024> kTurbo1024 = make_colormap<1024>(kTurboStops);
+
+} // namespace color
@@ -0,0 +1,265 @@
+#include "gradient.hpp"
+
+#include "internal/math.hpp"
+#include "transformation.hpp"
+
+#include <cassert>
+
+namespace color {
+
+// Bring components that overshoot back into the valid range of their space before converting.
+static sRgb finish_components(ColorSpace space, internal::Vector3f values) {
+  switch (space) {
+  case ColorSpace::sRgb:
+    internal::vector3f_map(values, values, internal::clampf);
+    break;
+  case ColorSpace::Hsv:
+  case ColorSpace::Hsl:
+    values[0] -= internal::floorf(values[0]);
+    values[1] = internal::clampf(values[1]);
+    values[2] = internal::clampf(values[2]);
+    break;
+  case ColorSpace::Xyz:
+  case ColorSpace::Lab:
+    break;
+  }
+  return from_space(values, space);
+}
+
+// Find the segment containing t when [0, 1] is split evenly into segments, along with the local
+// parameter u in [0, 1] within that segment.
+static int locate_segment(int segment_count, float t, float* u) {
+  const float indexf = segment_count * internal::clampf(t);
+  const int i = internal::min(int(indexf), segment_count - 1);
+  *u = indexf - i;
+  return i;
+}
+
+// Tangent at a knot for a monotone cubic given the slopes of the segments on either side.
+//
+// This uses the Fritsch-Butland harmonic mean which never exceeds twice the smaller slope, keeping
+// each segment inside the Fritsch-Carlson monotonicity region without a separate limiting pass.
+// References:
+//  https://en.wikipedia.org/wiki/Monotone_cubic_interpolation
+//  https://doi.org/10.1137/0905021
+static float monotone_tangent(float d0, float d1) {
+  if (d0 * d1 <= 0.0f) {
+    return 0.0f;
+  }
+  return 2.0f * d0 * d1 / (d0 + d1);
+}
+
+SplineGradient::SplineGradient(PaletteView palette, ColorSpace space, SplineType type)
+    : space_(space) {
+  assert(!palette.empty());
+  const int size = int(palette.size());
+  const int segment_count = internal::max(size - 1, 1);
+
+  // Mirror a phantom point past each end so the curves start and end on the end colors.
+  std::vector<float> points[3];
+  for (int c = 0; c < 3; c++) {
+    points[c].resize(size + 2);
+  }
+  for (int i = 0; i < size; i++) {
+    internal::Vector3f values;
+    to_space(palette[i], space, values);
+    for (int c = 0; c < 3; c++) {
+      points[c][i + 1] = values[c];
+    }
+  }
+  for (int c = 0; c < 3; c++) {
+    std::vector<float>& p = points[c];
+    if (size == 1) {
+      p[2] = p[1];
+    }
+    p[0] = 2.0f * p[1] - p[2];
+    p[size + 1] = 2.0f * p[size] - p[size - 1];
+  }
+
+  segments_.resize(segment_count);
+  for (int c = 0; c < 3; c++) {
+    const std::vector<float>& p = points[c];
+    for (int i = 0; i < segment_count; i++) {
+      // The segment runs from p1 to p2 with p0 and p3 as the neighboring knots.
+      const float p0 = p[i];
+      const float p1 = p[i + 1];
+      const float p2 = p[internal::min(i + 2, size)];
+      const float p3 = p[internal::min(i + 3, size + 1)];
+      float* k = segments_[i].coefficients[c];
+
+      switch (type) {
+      case SplineType::CatmullRom:
+        k[0] = p1;
+        k[1] = 0.5f * (p2 - p0);
+        k[2] = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+        k[3] = 0.5f * (-p0 + 3.0f * p1 - 3.0f * p2 + p3);
+        break;
+      case SplineType::BSpline:
+        k[0] = (p0 + 4.0f * p1 + p2) / 6.0f;
+        k[1] = 0.5f * (p2 - p0);
+        k[2] = 0.5f * (p0 - 2.0f * p1 + p2);
+        k[3] = (-p0 + 3.0f * p1 - 3.0f * p2 + p3) / 6.0f;
+        break;
+      case SplineType::MonotoneCubic: {
+        // End tangents use the one-sided slope rather than the mirrored phantom points.
+        const float d = p2 - p1;
+        const float m1 = (i == 0) ? d : monotone_tangent(p1 - p0, d);
+        const float m2 = (i == segment_count - 1) ? d : monotone_tangent(d, p3 - p2);
+        k[0] = p1;
+        k[1] = m1;
+        k[2] = 3.0f * d - 2.0f * m1 - m2;
+        k[3] = -2.0f * d + m1 + m2;
+        break;
+      }
+      }
+    }
+  }
+}
+
+sRgb SplineGradient::sample(float t) const {
+  float u;
+  const Segment& segment = segments_[locate_segment(int(segments_.size()), t, &u)];
+  internal::Vector3f values;
+  for (int c = 0; c < 3; c++) {
+    const float* k = segment.coefficients[c];
+    values[c] = k[0] + u * (k[1] + u * (k[2] + u * k[3]));
+  }
+  return finish_components(space_, values);
+}
+
+// Change in hue from hue_0 to hue_1 going the requested way around the unit hue circle.
+static float hue_delta(float hue_0, float hue_1, HueDirection direction) {
+  float delta = hue_1 - hue_0;
+  switch (direction) {
+  case HueDirection::Shortest:
+    if (delta > 0.5f) {
+      delta -= 1.0f;
+    } else if (delta < -0.5f) {
+      delta += 1.0f;
+    }
+    break;
+  case HueDirection::Longest:
+    if (delta > 0.0f && delta < 0.5f) {
+      delta -= 1.0f;
+    } else if (delta < 0.0f && delta > -0.5f) {
+      delta += 1.0f;
+    }
+    break;
+  case HueDirection::Increasing:
+    if (delta < 0.0f) {
+      delta += 1.0f;
+    }
+    break;
+  case HueDirection::Decreasing:
+    if (delta > 0.0f) {
+      delta -= 1.0f;
+    }
+    break;
+  }
+  return delta;
+}
+
+HueGradient::HueGradient(PaletteView palette, HueSpace space, HueDirection direction)
+    : space_(space == HueSpace::Hsv ? ColorSpace::Hsv : ColorSpace::Hsl) {
+  assert(!palette.empty());
+  const int size = int(palette.size());
+  std::vector<float> stops(3 * size);
+  for (int i = 0; i < size; i++) {
+    to_space(palette[i], space_, &stops[3 * i]);
+  }
+
+  const int segment_count = internal::max(size - 1, 1);
+  segments_.resize(segment_count);
+  for (int i = 0; i < segment_count; i++) {
+    const float* p0 = &stops[3 * i];
+    const float* p1 = &stops[3 * internal::min(i + 1, size - 1)];
+    Segment& segment = segments_[i];
+    for (int c = 1; c < 3; c++) {
+      segment.start[c] = p0[c];
+      segment.delta[c] = p1[c] - p0[c];
+    }
+
+    // Hue is meaningless without saturation, so borrow it from the other end of the segment.
+    const float hue_0 = (p0[1] == 0.0f) ? p1[0] : p0[0];
+    const float hue_1 = (p1[1] == 0.0f) ? hue_0 : p1[0];
+    segment.start[0] = hue_0;
+    segment.delta[0] = hue_delta(hue_0, hue_1, direction);
+  }
+}
+
+sRgb HueGradient::sample(float t) const {
+  float u;
+  const Segment& segment = segments_[locate_segment(int(segments_.size()), t, &u)];
+  internal::Vector3f values;
+  for (int c = 0; c < 3; c++) {
+    values[c] = segment.start[c] + u * segment.delta[c];
+  }
+  values[0] -= internal::floorf(values[0]);
+  return from_space(values, space_);
+}
+
+UniformGradient::UniformGradient(PaletteView palette, std::size_t resolution) : length_(0.0f) {
+  assert(!palette.empty());
+  for (const sRgb& srgb : palette) {
+    stops_.push_back(to_lab(to_xyz(srgb)));
+  }
+  if (stops_.size() == 1) {
+    stops_.push_back(stops_.front());
+  }
+
+  // Lab is linear along each segment, so each segment's arc length is exactly its delta E.
+  const int segment_count = int(stops_.size()) - 1;
+  std::vector<float> arc_lengths(segment_count + 1, 0.0f);
+  for (int i = 0; i < segment_count; i++) {
+    float distance = 0.0f;
+    for (int c = 0; c < 3; c++) {
+      distance += internal::const_powf<2>(stops_[i + 1].values[c] - stops_[i].values[c]);
+    }
+    arc_lengths[i + 1] = arc_lengths[i] + internal::sqrtf(distance);
+  }
+  length_ = arc_lengths.back();
+
+  const int table_size = internal::max(int(resolution), 2);
+  parameters_.resize(table_size);
+  int i = 0;
+  for (int k = 0; k < table_size; k++) {
+    const float position = float(k) / float(table_size - 1);
+    if (length_ == 0.0f) {
+      // A palette of a single repeated color has no length to walk, so fall back to plain t.
+      parameters_[k] = position * segment_count;
+      continue;
+    }
+    const float arc_length = position * length_;
+    while (i < segment_count - 1 && arc_lengths[i + 1] <= arc_length) {
+      i++;
+    }
+    const float segment_length = arc_lengths[i + 1] - arc_lengths[i];
+    const float u = (segment_length > 0.0f) ? (arc_length - arc_lengths[i]) / segment_length : 0.0f;
+    parameters_[k] = i + internal::clampf(u);
+  }
+}
+
+sRgb UniformGradient::sample(float t) const {
+  float f;
+  const int j = locate_segment(int(parameters_.size()) - 1, t, &f);
+  const float parameter = parameters_[j] + f * (parameters_[j + 1] - parameters_[j]);
+
+  const int segment_count = int(stops_.size()) - 1;
+  const int i = internal::min(int(parameter), segment_count - 1);
+  const float u = parameter - i;
+  const Lab& p0 = stops_[i];
+  const Lab& p1 = stops_[i + 1];
+  Lab lab;
+  for (int c = 0; c < 3; c++) {
+    lab.values[c] = p0.values[c] + u * (p1.values[c] - p0.values[c]);
+  }
+  return to_srgb(to_xyz(lab));
+}
+
+Palette create_uniform_palette(PaletteView palette, std::size_t count) {
+  Palette uniform(count);
+  UniformGradient(palette).sample_uniform(count, uniform.data());
+  return uniform;
+}
+
+} // namespace color
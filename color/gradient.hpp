@@ -0,0 +1,138 @@
+#pragma once
+
+#include "palette.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace color {
+
+// Batch sampling shared by every gradient, which only has to provide sample(float t).
+template <typename GradientType> class BatchSampler {
+public:
+  // Sample the gradient at each of the count values in t.
+  void sample(const float* t, std::size_t count, sRgb* output) const {
+    const GradientType& gradient = static_cast<const GradientType&>(*this);
+    for (std::size_t i = 0; i < count; i++) {
+      output[i] = gradient.sample(t[i]);
+    }
+  }
+
+  // Sample count evenly spaced values of t from 0 to 1 inclusive.
+  void sample_uniform(std::size_t count, sRgb* output) const {
+    const GradientType& gradient = static_cast<const GradientType&>(*this);
+    const float step = (count > 1) ? 1.0f / float(count - 1) : 0.0f;
+    for (std::size_t i = 0; i < count; i++) {
+      output[i] = gradient.sample(float(i) * step);
+    }
+  }
+};
+
+// The cubic curve fit through the palette colors of a SplineGradient.
+enum class SplineType {
+  // Interpolating spline through every palette color with tangents taken from its neighbors.
+  CatmullRom,
+  // Approximating uniform cubic B-spline. Smoother than Catmull-Rom, but only passes through the
+  // first and last palette colors.
+  BSpline,
+  // Interpolating spline whose tangents are limited so no component overshoots its neighbors.
+  MonotoneCubic,
+};
+
+// A piecewise cubic gradient through the colors of a palette, evaluated in any supported space.
+//
+// The palette is converted once and each segment's polynomial coefficients are computed at
+// construction, so sampling is a Horner evaluation followed by a single conversion back to sRgb.
+// Hue is fit as a plain scalar in HSV and HSL and wrapped back into [0, 1) on output.
+class SplineGradient : public BatchSampler<SplineGradient> {
+public:
+  using BatchSampler<SplineGradient>::sample;
+
+  // The palette must not be empty.
+  SplineGradient(PaletteView palette, ColorSpace space, SplineType type);
+
+  // Sample the gradient at t in [0, 1].
+  sRgb sample(float t) const;
+
+private:
+  // Cubic coefficients, lowest order first, for each of the three components of a segment.
+  struct Segment {
+    float coefficients[3][4];
+  };
+
+  ColorSpace space_;
+  std::vector<Segment> segments_;
+};
+
+// The cylindrical spaces a HueGradient can interpolate in.
+enum class HueSpace { Hsv, Hsl };
+
+// The way around the hue circle taken between two colors by a HueGradient.
+enum class HueDirection {
+  // Take the arc of at most half a turn.
+  Shortest,
+  // Take the arc of at least half a turn.
+  Longest,
+  // Always move towards higher hue, wrapping from 1 to 0.
+  Increasing,
+  // Always move towards lower hue, wrapping from 0 to 1.
+  Decreasing,
+};
+
+// A piecewise linear gradient in HSV or HSL that treats hue as an angle.
+//
+// The palette is converted and the arc taken between each pair of colors is resolved once at
+// construction, so sampling is a lerp, a fractional wrap of the hue and a single conversion back to
+// sRgb. An achromatic color takes the hue of its neighbor so grays do not swing the hue around.
+class HueGradient : public BatchSampler<HueGradient> {
+public:
+  using BatchSampler<HueGradient>::sample;
+
+  // The palette must not be empty.
+  HueGradient(PaletteView palette, HueSpace space, HueDirection direction);
+
+  // Sample the gradient at t in [0, 1].
+  sRgb sample(float t) const;
+
+private:
+  // The starting components of a segment and the change across it, with hue left unwrapped.
+  struct Segment {
+    float start[3];
+    float delta[3];
+  };
+
+  ColorSpace space_;
+  std::vector<Segment> segments_;
+};
+
+// A gradient linear in L*a*b* and reparameterized by perceptual arc length.
+//
+// Equal steps in t cover equal CIE76 color differences (delta E*ab) along the palette, rather than
+// an equal share of each palette segment. The arc length is tabulated at construction into an
+// inverse table of the given resolution, so sampling costs one interpolated table lookup on top of
+// plain linear interpolation in L*a*b*.
+class UniformGradient : public BatchSampler<UniformGradient> {
+public:
+  using BatchSampler<UniformGradient>::sample;
+
+  // The palette must not be empty.
+  explicit UniformGradient(PaletteView palette, std::size_t resolution = 256);
+
+  // Sample the gradient at t in [0, 1].
+  sRgb sample(float t) const;
+
+  // The total perceptual length of the gradient in delta E*ab.
+  float length() const { return length_; }
+
+private:
+  std::vector<Lab> stops_;
+  // Palette parameter in [0, stops - 1] at evenly spaced arc lengths along the gradient.
+  std::vector<float> parameters_;
+  float length_;
+};
+
+// Create a palette of count colors evenly spaced in perceptual arc length along the given palette,
+// which must not be empty.
+Palette create_uniform_palette(PaletteView palette, std::size_t count);
+
+} // namespace color
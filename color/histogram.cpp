@@ -0,0 +1,188 @@
+#include "histogram.hpp"
+
+#include "internal/math.hpp"
+#include "internal/parallel.hpp"
+#include "transformation.hpp"
+
+namespace color {
+
+// Pixels are converted this many at a time into a buffer on the stack before binning.
+static const std::size_t kBatchSize = 1024;
+
+HistogramBinning create_binning(ColorSpace space, int bins_0, int bins_1, int bins_2) {
+  HistogramBinning binning{space,
+                           {bins_0, bins_1, bins_2},
+                           {0.0f, 0.0f, 0.0f},
+                           {1.0f, 1.0f, 1.0f},
+                           0.0f};
+  switch (space) {
+  case ColorSpace::sRgb:
+  case ColorSpace::Hsv:
+  case ColorSpace::Hsl:
+    break;
+  case ColorSpace::Xyz:
+    // The D65 white point bounds XYZ for colors within the sRGB gamut.
+    binning.max[0] = 0.95047f;
+    binning.max[2] = 1.08883f;
+    break;
+  case ColorSpace::Lab:
+    binning.max[0] = 100.0f;
+    binning.min[1] = binning.min[2] = -128.0f;
+    binning.max[1] = binning.max[2] = 128.0f;
+    break;
+  }
+  return binning;
+}
+
+static bool has_hue(const HistogramBinning& binning) {
+  return binning.space == ColorSpace::Hsv || binning.space == ColorSpace::Hsl;
+}
+
+static std::size_t hue_bin_count(const HistogramBinning& binning) {
+  return std::size_t(binning.bins[0]) * binning.bins[1] * binning.bins[2];
+}
+
+bool separates_achromatic(const HistogramBinning& binning) {
+  return has_hue(binning) && binning.bins[0] > 1;
+}
+
+std::size_t bin_count(const HistogramBinning& binning) {
+  const std::size_t achromatic =
+      separates_achromatic(binning) ? std::size_t(binning.bins[1]) * binning.bins[2] : 0;
+  return hue_bin_count(binning) + achromatic;
+}
+
+std::size_t find_bin(const HistogramBinning& binning, const float values[3]) {
+  // Achromatic colors skip the hue channel and are binned after all of the hue bins.
+  const bool achromatic =
+      separates_achromatic(binning) && values[1] <= binning.achromatic_saturation;
+  std::size_t bin = 0;
+  for (int c = achromatic ? 1 : 0; c < 3; c++) {
+    // Hue is an angle, so wrap it onto the circle rather than clamping it into the end bins.
+    const bool hue = has_hue(binning) && c == 0;
+    const float value = hue ? values[c] - internal::floorf(values[c]) : values[c];
+    const int bins = binning.bins[c];
+    const float position = (value - binning.min[c]) / (binning.max[c] - binning.min[c]);
+    // Compare before converting, since NaN or huge positions do not fit in an int. NaN fails both
+    // comparisons and takes the first bin.
+    const float scaled = position * bins;
+    const int i = (scaled >= float(bins)) ? bins - 1 : ((scaled > 0.0f) ? int(scaled) : 0);
+    bin = bin * bins + i;
+  }
+  return achromatic ? hue_bin_count(binning) + bin : bin;
+}
+
+Histogram::Histogram(const HistogramBinning& binning)
+    : binning_(binning), counts_(bin_count(binning), 0) {}
+
+uint64_t Histogram::count(int bin_0, int bin_1, int bin_2) const {
+  return counts_[(std::size_t(bin_0) * binning_.bins[1] + bin_1) * binning_.bins[2] + bin_2];
+}
+
+uint64_t Histogram::achromatic() const {
+  uint64_t total = 0;
+  for (std::size_t i = hue_bin_count(binning_); i < counts_.size(); i++) {
+    total += counts_[i];
+  }
+  return total;
+}
+
+uint64_t Histogram::achromatic_count(int bin_1, int bin_2) const {
+  if (!separates_achromatic(binning_)) {
+    return 0;
+  }
+  return counts_[hue_bin_count(binning_) + std::size_t(bin_1) * binning_.bins[2] + bin_2];
+}
+
+uint64_t Histogram::total() const {
+  uint64_t total = 0;
+  for (uint64_t count : counts_) {
+    total += count;
+  }
+  return total;
+}
+
+void Histogram::merge(const Histogram& other) {
+  for (std::size_t i = 0; i < counts_.size(); i++) {
+    counts_[i] += other.counts_[i];
+  }
+}
+
+// Run add(histogram, begin, end) over chunks of the pixels, each into its own private histogram,
+// and merge the results.
+template <typename AddFunction>
+static Histogram build_parallel(std::size_t count, const HistogramBinning& binning,
+                                unsigned int threads, AddFunction add) {
+  const std::size_t chunks =
+      internal::parallel_chunk_count(count, internal::kMinParallelChunk, threads);
+  std::vector<Histogram> histograms(chunks, Histogram(binning));
+  internal::parallel_for_chunks(count, chunks, [&](std::size_t chunk, std::size_t begin,
+                                                   std::size_t end) {
+    add(&histograms[chunk], begin, end);
+  });
+
+  for (std::size_t chunk = 1; chunk < chunks; chunk++) {
+    histograms[0].merge(histograms[chunk]);
+  }
+  return histograms[0];
+}
+
+template <typename PixelType>
+static Histogram build_converted(const PixelType* pixels, std::size_t count,
+                                 const HistogramBinning& binning, unsigned int threads) {
+  return build_parallel(count, binning, threads,
+                        [&](Histogram* histogram, std::size_t begin, std::size_t end) {
+                          float values[3 * kBatchSize];
+                          for (std::size_t i = begin; i < end; i += kBatchSize) {
+                            const std::size_t batch = internal::min(end - i, kBatchSize);
+                            to_space(pixels + i, batch, binning.space, values);
+                            for (std::size_t j = 0; j < batch; j++) {
+                              histogram->add(values + 3 * j);
+                            }
+                          }
+                        });
+}
+
+Histogram build_histogram(const sRgb* pixels, std::size_t count, const HistogramBinning& binning,
+                          unsigned int threads) {
+  return build_converted(pixels, count, binning, threads);
+}
+
+Histogram build_histogram(const rgb888_t* pixels, std::size_t count,
+                          const HistogramBinning& binning, unsigned int threads) {
+  return build_converted(pixels, count, binning, threads);
+}
+
+HistogramBinMap::HistogramBinMap(const HistogramBinning& binning, unsigned int threads)
+    : binning_(binning), bins_(std::size_t(1) << 24) {
+  const std::size_t count = bins_.size();
+  const std::size_t chunks =
+      internal::parallel_chunk_count(count, internal::kMinParallelChunk, threads);
+  internal::parallel_for_chunks(count, chunks, [&](std::size_t, std::size_t begin,
+                                                   std::size_t end) {
+    rgb888_t colors[kBatchSize];
+    float values[3 * kBatchSize];
+    for (std::size_t i = begin; i < end; i += kBatchSize) {
+      const std::size_t batch = internal::min(end - i, kBatchSize);
+      for (std::size_t j = 0; j < batch; j++) {
+        colors[j] = rgb888_t(i + j);
+      }
+      to_space(colors, batch, binning_.space, values);
+      for (std::size_t j = 0; j < batch; j++) {
+        bins_[i + j] = uint32_t(find_bin(binning_, values + 3 * j));
+      }
+    }
+  });
+}
+
+Histogram build_histogram(const rgb888_t* pixels, std::size_t count, const HistogramBinMap& map,
+                          unsigned int threads) {
+  return build_parallel(count, map.binning(), threads,
+                        [&](Histogram* histogram, std::size_t begin, std::size_t end) {
+                          for (std::size_t i = begin; i < end; i++) {
+                            histogram->add_to_bin(map.bin(pixels[i]));
+                          }
+                        });
+}
+
+} // namespace color
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "space.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace color {
+
+// How a histogram divides a color space into bins.
+//
+// Each channel is split into bins evenly spaced from min to max, with values outside clamped into
+// the end bins, except for hue which wraps around. A channel with a single bin is effectively
+// ignored, so a hue histogram is an HSV binning with {36, 1, 1} bins.
+//
+// Grays have no meaningful hue, so when an HSV or HSL binning splits hue into more than one bin,
+// colors with a saturation at or below achromatic_saturation are counted apart from the hue bins
+// instead of landing in the red ones. They are still binned by saturation and value or lightness.
+struct HistogramBinning {
+  ColorSpace space;
+  int bins[3];
+  float min[3];
+  float max[3];
+  float achromatic_saturation;
+};
+
+// Create a binning over the full range of each channel of the space. L*a*b* uses [0, 100] for
+// lightness and [-128, 128] for a and b. Only colors with zero saturation are achromatic.
+HistogramBinning create_binning(ColorSpace space, int bins_0, int bins_1, int bins_2);
+
+// Whether the binning counts achromatic colors apart from its hue bins.
+bool separates_achromatic(const HistogramBinning& binning);
+
+// The number of flat bin indices of the binning. When achromatic colors are separated, their
+// bins[1] * bins[2] bins follow the bins[0] * bins[1] * bins[2] hue bins.
+std::size_t bin_count(const HistogramBinning& binning);
+
+// The flat index of the bin holding a color given as components of the binning's space. NaN
+// components fall in the first bin of their channel.
+std::size_t find_bin(const HistogramBinning& binning, const float values[3]);
+
+// Counts of colors per bin, stored flat with the last channel varying fastest and followed by any
+// achromatic bins.
+class Histogram {
+public:
+  explicit Histogram(const HistogramBinning& binning);
+
+  const HistogramBinning& binning() const { return binning_; }
+
+  std::size_t size() const { return counts_.size(); }
+  const std::vector<uint64_t>& counts() const { return counts_; }
+  uint64_t count(int bin_0, int bin_1, int bin_2) const;
+  uint64_t total() const;
+
+  // The number of HSV or HSL colors counted apart from the hue bins as achromatic, in total and
+  // per saturation and value or lightness bin. They are included in the total.
+  uint64_t achromatic() const;
+  uint64_t achromatic_count(int bin_1, int bin_2) const;
+
+  // Add a color given as components of the binning's space.
+  void add(const float values[3]) { add_to_bin(find_bin(binning_, values)); }
+
+  // Add a color already known to fall in the given flat bin index.
+  void add_to_bin(std::size_t bin) { counts_[bin]++; }
+
+  // Add the counts of another histogram with the same binning.
+  void merge(const Histogram& other);
+
+private:
+  HistogramBinning binning_;
+  std::vector<uint64_t> counts_;
+};
+
+// A precomputed bin for every rgb888_t color, so 8-bit pixels are binned without any conversion.
+//
+// Building the map converts all 2^24 colors once and takes 64 MiB, so it pays off when reused
+// across many images with the same binning. The binning must have fewer than 2^32 bins.
+class HistogramBinMap {
+public:
+  explicit HistogramBinMap(const HistogramBinning& binning, unsigned int threads = 0);
+
+  const HistogramBinning& binning() const { return binning_; }
+
+  uint32_t bin(rgb888_t rgb888) const { return bins_[rgb888 & 0xffffff]; }
+
+private:
+  HistogramBinning binning_;
+  std::vector<uint32_t> bins_;
+};
+
+// Build a histogram of count pixels. Each thread converts its pixels in batches into a private
+// histogram and the private histograms are merged at the end. Zero threads uses every hardware
+// thread.
+Histogram build_histogram(const sRgb* pixels, std::size_t count, const HistogramBinning& binning,
+                          unsigned int threads = 0);
+Histogram build_histogram(const rgb888_t* pixels, std::size_t count,
+                          const HistogramBinning& binning, unsigned int threads = 0);
+Histogram build_histogram(const rgb888_t* pixels, std::size_t count, const HistogramBinMap& map,
+                          unsigned int threads = 0);
+
+} // namespace color
@@ -9,10 +9,14 @@ namespace internal {
 
 float powf(float base, float exponent) { return std::pow(base, exponent); }
 
+float sqrtf(float value) { return std::sqrt(value); }
+
 float roundf(float value) { return round(value); }
 
 bool isnanf(float value) { return std::isnan(value); }
 
+bool isfinitef(float value) { return std::isfinite(value); }
+
 float floorf(float value) { return floor(value); }
 
 float ceilf(float value) { return ceil(value); }
@@ -6,11 +6,13 @@ namespace color {
 
 namespace internal {
 bool isnanf(float value);
+bool isfinitef(float value);
 float modf(float value, float divisor);
 float roundf(float value);
 float floorf(float value);
 float ceilf(float value);
 float powf(float base, float exponent);
+float sqrtf(float value);
 
 using Vector3f = float[3];
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace color {
+
+namespace internal {
+
+// Resolve a requested thread count, where zero asks for one thread per hardware thread.
+inline unsigned int resolve_thread_count(unsigned int requested) {
+  if (requested != 0) {
+    return requested;
+  }
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 1 : hardware;
+}
+
+// The default smallest chunk of items worth giving its own thread, large enough that thread startup
+// and any merging of per-thread results are negligible next to the work in it.
+const std::size_t kMinParallelChunk = 1 << 16;
+
+// The number of chunks to split count items into so that each thread gets at most one chunk and no
+// chunk is smaller than min_chunk items, unless there is only one.
+inline std::size_t parallel_chunk_count(std::size_t count, std::size_t min_chunk,
+                                        unsigned int threads) {
+  const std::size_t by_size = (min_chunk == 0) ? count : count / min_chunk;
+  const std::size_t resolved = resolve_thread_count(threads);
+  const std::size_t chunks = by_size < resolved ? by_size : resolved;
+  return chunks == 0 ? 1 : chunks;
+}
+
+// Split [0, count) into chunks contiguous ranges and call function(chunk, begin, end) for each, one
+// thread per chunk. The calling thread runs the first chunk and waits for the rest to finish.
+template <typename FunctionType>
+void parallel_for_chunks(std::size_t count, std::size_t chunks, FunctionType function) {
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  for (std::size_t chunk = 1; chunk < chunks; chunk++) {
+    const std::size_t begin = count * chunk / chunks;
+    const std::size_t end = count * (chunk + 1) / chunks;
+    workers.emplace_back([=] { function(chunk, begin, end); });
+  }
+  function(std::size_t(0), std::size_t(0), count / chunks);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace internal
+
+} // namespace color
@@ -6,7 +6,7 @@
 
 namespace color {
 	
-sRgb interpolate_nearest_neighbor(const Palette& palette, float t) {
+sRgb interpolate_nearest_neighbor(PaletteView palette, float t) {
   const float indexf = (palette.size() - 1) * t;
   const int i = internal::roundf(indexf);
   return palette[i];
@@ -39,7 +39,7 @@ template <> struct Converter<sRgb> {
 };
 
 template <typename ColorSpaceType>
-ColorSpaceType interpolate_color_space_linear(const Palette& palette, float t) {
+ColorSpaceType interpolate_color_space_linear(PaletteView palette, float t) {
   const float indexf = (palette.size() - 1) * t;
   const int i_0 = int(internal::floorf(indexf));
   const int i_1 = int(internal::ceilf(indexf));
@@ -57,23 +57,23 @@ ColorSpaceType interpolate_color_space_linear(const Palette& palette, float t) {
   return lerp;
 }
 
-sRgb interpolate_linear(const Palette& palette, float t) {
+sRgb interpolate_linear(PaletteView palette, float t) {
   return interpolate_color_space_linear<sRgb>(palette, t);
 }
 
-sRgb interpolate_hsv_linear(const Palette& palette, float t) {
+sRgb interpolate_hsv_linear(PaletteView palette, float t) {
   return to_srgb(interpolate_color_space_linear<Hsv>(palette, t));
 }
 
-sRgb interpolate_hsl_linear(const Palette& palette, float t) {
+sRgb interpolate_hsl_linear(PaletteView palette, float t) {
   return to_srgb(interpolate_color_space_linear<Hsl>(palette, t));
 }
 
-sRgb interpolate_xyz_linear(const Palette& palette, float t) {
+sRgb interpolate_xyz_linear(PaletteView palette, float t) {
   return to_srgb(interpolate_color_space_linear<Xyz>(palette, t));
 }
 
-sRgb interpolate_lab_linear(const Palette& palette, float t) {
+sRgb interpolate_lab_linear(PaletteView palette, float t) {
   return to_srgb(to_xyz(interpolate_color_space_linear<Lab>(palette, t)));
 }
 	
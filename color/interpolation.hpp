@@ -5,21 +5,21 @@
 namespace color {
 	
 // Perform nearest neighbor interpolation, picking the palette color closest to the point t.
-sRgb interpolate_nearest_neighbor(const Palette& palette, float t);
+sRgb interpolate_nearest_neighbor(PaletteView palette, float t);
 
 // Interpolate linearly in the sRGB space  and return an sRgb color.
-sRgb interpolate_linear(const Palette& palette, float t);
+sRgb interpolate_linear(PaletteView palette, float t);
 
 // Interpolate linearly in the HSV space and return an sRgb color.
-sRgb interpolate_hsv_linear(const Palette& palette, float t);
+sRgb interpolate_hsv_linear(PaletteView palette, float t);
 
 // Interpolate linearly in the HSL space and return an sRgb color.
-sRgb interpolate_hsl_linear(const Palette& palette, float t);
+sRgb interpolate_hsl_linear(PaletteView palette, float t);
 
 // Interpolate linearly in the Lab space and return an sRgb color.
-sRgb interpolate_lab_linear(const Palette& palette, float t);
+sRgb interpolate_lab_linear(PaletteView palette, float t);
 
 // Interpolate linearly in the XYZ space and return an sRgb color.
-sRgb interpolate_xyz_linear(const Palette& palette, float t);
+sRgb interpolate_xyz_linear(PaletteView palette, float t);
 	
 }
@@ -12,5 +12,12 @@ Palette create_palette(const color::rgb888_t* data, std::size_t size) {
   }
   return palette;
 }
+
+PaletteView create_palette(const rgb888_t* data, std::size_t size, sRgb* storage) {
+  for (std::size_t i = 0; i < size; i++) {
+    storage[i] = to_srgb(data[i]);
+  }
+  return PaletteView(storage, size);
+}
 	
 } // namespace color
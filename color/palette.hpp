@@ -2,6 +2,7 @@
 
 #include "space.hpp"
 
+#include <cstddef>
 #include <vector>
 
 namespace color {
@@ -11,6 +12,72 @@ namespace color {
 // as functions use the .size() routine appropriately.
 using Palette = std::vector<sRgb>;
 
+// A non-owning view of palette colors stored elsewhere, such as a Palette, a static array or an
+// arena buffer. The viewed colors must outlive the view.
+class PaletteView {
+public:
+  PaletteView(const sRgb* data, std::size_t size) : data_(data), size_(size) {}
+
+  PaletteView(const Palette& palette) : data_(palette.data()), size_(palette.size()) {}
+
+  template <std::size_t Size> PaletteView(const sRgb(&values)[Size]) : data_(values), size_(Size) {}
+
+  const sRgb* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const sRgb& operator[](std::size_t i) const { return data_[i]; }
+  const sRgb& front() const { return data_[0]; }
+  const sRgb& back() const { return data_[size_ - 1]; }
+
+  const sRgb* begin() const { return data_; }
+  const sRgb* end() const { return data_ + size_; }
+
+private:
+  const sRgb* data_;
+  std::size_t size_;
+};
+
+// A palette with fixed capacity that stores its colors inline rather than on the heap.
+template <std::size_t Capacity> class InlinePalette {
+public:
+  InlinePalette() : size_(0) {}
+
+  // Append a color. Returns false and leaves the palette unchanged if it is already full.
+  bool push_back(const sRgb& srgb) {
+    if (size_ == Capacity) {
+      return false;
+    }
+    values_[size_++] = srgb;
+    return true;
+  }
+
+  // Change the number of colors, up to the capacity. New colors are left uninitialized.
+  void resize(std::size_t size) { size_ = (size < Capacity) ? size : Capacity; }
+
+  void clear() { size_ = 0; }
+
+  sRgb* data() { return values_; }
+  const sRgb* data() const { return values_; }
+  std::size_t size() const { return size_; }
+  static constexpr std::size_t capacity() { return Capacity; }
+  bool empty() const { return size_ == 0; }
+
+  sRgb& operator[](std::size_t i) { return values_[i]; }
+  const sRgb& operator[](std::size_t i) const { return values_[i]; }
+
+  sRgb* begin() { return values_; }
+  sRgb* end() { return values_ + size_; }
+  const sRgb* begin() const { return values_; }
+  const sRgb* end() const { return values_ + size_; }
+
+  operator PaletteView() const { return PaletteView(values_, size_); }
+
+private:
+  sRgb values_[Capacity];
+  std::size_t size_;
+};
+
 // Create a palette from a rgb888_t array pointer and size.
 Palette create_palette(const rgb888_t* data, std::size_t size);
 
@@ -18,5 +85,18 @@ Palette create_palette(const rgb888_t* data, std::size_t size);
 template <std::size_t Size> Palette create_palette(const rgb888_t(&values)[Size]) {
   return create_palette(values, Size);
 }
+
+// Create a palette in caller-provided storage with room for at least size colors, returning a view
+// of the written colors. This does not allocate.
+PaletteView create_palette(const rgb888_t* data, std::size_t size, sRgb* storage);
+
+// Create an inline palette from a fixed size rgb888_t array.
+template <std::size_t Size>
+InlinePalette<Size> create_inline_palette(const rgb888_t(&values)[Size]) {
+  InlinePalette<Size> palette;
+  palette.resize(Size);
+  create_palette(values, Size, palette.data());
+  return palette;
+}
 	
 } // namespace color
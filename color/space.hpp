@@ -6,6 +6,10 @@ namespace color {
 	
 typedef uint32_t rgb888_t;
 
+// An 8-bit per channel color with alpha, packed with red in the lowest byte so that the bytes in
+// memory are red, green, blue, alpha on little endian platforms.
+typedef uint32_t rgba8888_t;
+
 struct uRgb {
   union {
     uint8_t values[3];
@@ -60,4 +64,7 @@ struct Lab {
   };
 };
 
+// Identifies a color space at runtime for routines that can operate in any supported space.
+enum class ColorSpace { sRgb, Hsv, Hsl, Xyz, Lab };
+
 } // namespace color
@@ -1,5 +1,6 @@
 #include "transformation.hpp"
 
+#include "cache.hpp"
 #include "internal/math.hpp"
 
 namespace color {
@@ -223,6 +224,19 @@ rgb888_t to_rgb888(uRgb urgb) {
   return rgb888;
 }
 
+// Clamp a channel into [0, 1] before rounding it to 8 bits, mapping NaN to zero.
+static rgba8888_t to_channel8(float value) {
+  if (internal::isnanf(value)) {
+    return 0;
+  }
+  return rgba8888_t(internal::roundf(internal::clampf(value) * 255.0f));
+}
+
+rgba8888_t to_rgba8888(const sRgb& srgb, uint8_t alpha) {
+  return (rgba8888_t(alpha) << 24) | (to_channel8(srgb.blue) << 16) |
+         (to_channel8(srgb.green) << 8) | (to_channel8(srgb.red) << 0);
+}
+
 uRgb to_urgb(rgb888_t rgb888) {
   uRgb urgb;
   urgb.red = (rgb888 >> 16) & 0xff;
@@ -322,4 +336,97 @@ sRgb to_srgb(const Hsl& hsl) {
   return hsc_to_srgb(hsl, chroma, dv);
 }
 
+template <typename ColorSpaceType>
+inline void copy_values(const ColorSpaceType& color, float output[3]) {
+  for (int i = 0; i < 3; i++) {
+    output[i] = color.values[i];
+  }
+}
+
+void to_space(const sRgb& srgb, ColorSpace space, float output[3]) {
+  switch (space) {
+  case ColorSpace::sRgb:
+    copy_values(srgb, output);
+    break;
+  case ColorSpace::Hsv:
+    copy_values(to_hsv(srgb), output);
+    break;
+  case ColorSpace::Hsl:
+    copy_values(to_hsl(srgb), output);
+    break;
+  case ColorSpace::Xyz:
+    copy_values(to_xyz(srgb), output);
+    break;
+  case ColorSpace::Lab:
+    copy_values(to_lab(to_xyz(srgb)), output);
+    break;
+  }
+}
+
+// Allow batches of sRgb colors to share the conversion code with other inputs.
+static inline const sRgb& to_srgb(const sRgb& srgb) { return srgb; }
+
+// Resolve the space once for a whole batch rather than once per color.
+template <typename InputType>
+void batch_to_space(const InputType* input, std::size_t count, ColorSpace space, float* output) {
+  switch (space) {
+  case ColorSpace::sRgb:
+    for (std::size_t i = 0; i < count; i++) {
+      copy_values(to_srgb(input[i]), output + 3 * i);
+    }
+    break;
+  case ColorSpace::Hsv:
+    for (std::size_t i = 0; i < count; i++) {
+      copy_values(to_hsv(to_srgb(input[i])), output + 3 * i);
+    }
+    break;
+  case ColorSpace::Hsl:
+    for (std::size_t i = 0; i < count; i++) {
+      copy_values(to_hsl(to_srgb(input[i])), output + 3 * i);
+    }
+    break;
+  case ColorSpace::Xyz:
+    for (std::size_t i = 0; i < count; i++) {
+      copy_values(to_xyz(to_srgb(input[i])), output + 3 * i);
+    }
+    break;
+  case ColorSpace::Lab:
+    for (std::size_t i = 0; i < count; i++) {
+      copy_values(to_lab(to_xyz(to_srgb(input[i]))), output + 3 * i);
+    }
+    break;
+  }
+}
+
+void to_space(const sRgb* input, std::size_t count, ColorSpace space, float* output) {
+  batch_to_space(input, count, space, output);
+}
+
+void to_space(const rgb888_t* input, std::size_t count, ColorSpace space, float* output,
+              ConversionCache* cache) {
+  if (cache == nullptr || cache->space() != space) {
+    batch_to_space(input, count, space, output);
+    return;
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    cache->convert(input[i], output + 3 * i);
+  }
+}
+
+sRgb from_space(const float input[3], ColorSpace space) {
+  switch (space) {
+  case ColorSpace::sRgb:
+    return sRgb{{input[0], input[1], input[2]}};
+  case ColorSpace::Hsv:
+    return to_srgb(Hsv{{input[0], input[1], input[2]}});
+  case ColorSpace::Hsl:
+    return to_srgb(Hsl{{input[0], input[1], input[2]}});
+  case ColorSpace::Xyz:
+    return to_srgb(Xyz{{input[0], input[1], input[2]}});
+  case ColorSpace::Lab:
+    return to_srgb(to_xyz(Lab{{input[0], input[1], input[2]}}));
+  }
+  return sRgb{{0.0f, 0.0f, 0.0f}};
+}
+
 } // namespace color
@@ -1,11 +1,18 @@
 #pragma once
 #include "space.hpp"
 
+#include <cstddef>
+
 namespace color {
+
+class ConversionCache;
 	
 rgb888_t to_rgb888(uRgb urgb);
 rgb888_t to_rgb888(sRgb srgb);
 
+// Channels outside of [0, 1] are clamped.
+rgba8888_t to_rgba8888(const sRgb& srgb, uint8_t alpha = 0xff);
+
 uRgb to_urgb(rgb888_t rgb888);
 uRgb to_urgb(const sRgb& srgb);
 
@@ -22,5 +29,17 @@ Xyz to_xyz(const sRgb& srgb);
 Xyz to_xyz(const Lab& lab);
 
 Lab to_lab(const Xyz& xyz);
+
+// Convert an sRgb color into the three components of the given color space.
+void to_space(const sRgb& srgb, ColorSpace space, float output[3]);
+
+// Convert the three components of the given color space into an sRgb color.
+sRgb from_space(const float input[3], ColorSpace space);
+
+// Convert count colors into interleaved components of the given color space, three per color.
+void to_space(const sRgb* input, std::size_t count, ColorSpace space, float* output);
+// Colors are looked up in the cache when one is given for the same space.
+void to_space(const rgb888_t* input, std::size_t count, ColorSpace space, float* output,
+              ConversionCache* cache = nullptr);
 	
 } // namespace color
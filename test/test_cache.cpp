@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <color/cache.hpp>
+#include <color/transformation.hpp>
+
+namespace color {
+
+TEST(ConversionCache, HitsAndMisses) {
+  ConversionCache cache(ColorSpace::Lab, 100);
+  ASSERT_EQ(128, cache.capacity());
+
+  float expected[3];
+  to_space(to_srgb(0xf0e68c), ColorSpace::Lab, expected);
+  for (int i = 0; i < 3; i++) {
+    float values[3];
+    cache.convert(0xf0e68c, values);
+    for (int c = 0; c < 3; c++) {
+      ASSERT_EQ(expected[c], values[c]);
+    }
+  }
+  ASSERT_EQ(1, cache.misses());
+  ASSERT_EQ(2, cache.hits());
+
+  cache.clear();
+  cache.reset_statistics();
+  float values[3];
+  cache.convert(0xf0e68c, values);
+  ASSERT_EQ(1, cache.misses());
+  ASSERT_EQ(0, cache.hits());
+}
+
+TEST(ConversionCache, BatchConversion) {
+  const int kCount = 64;
+  rgb888_t pixels[kCount];
+  for (int i = 0; i < kCount; i++) {
+    pixels[i] = (i % 2 == 0) ? 0x000000 : 0xef8a62;
+  }
+
+  float expected[3 * kCount];
+  float cached[3 * kCount];
+  ConversionCache cache(ColorSpace::Hsl);
+  to_space(pixels, kCount, ColorSpace::Hsl, expected);
+  to_space(pixels, kCount, ColorSpace::Hsl, cached, &cache);
+  for (int i = 0; i < 3 * kCount; i++) {
+    ASSERT_EQ(expected[i], cached[i]);
+  }
+  ASSERT_EQ(2, cache.misses());
+  ASSERT_EQ(kCount - 2, cache.hits());
+
+  // A cache for another space is bypassed.
+  to_space(pixels, kCount, ColorSpace::Xyz, cached, &cache);
+  ASSERT_EQ(kCount, cache.misses() + cache.hits());
+}
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <color/colorize.hpp>
+#include <color/interpolation.hpp>
+#include <color/transformation.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace color {
+
+TEST(Colorize, ExplicitRange) {
+  const rgb888_t data[] = {0x000000, 0xffffff};
+  const Palette palette = create_palette(data);
+  const float field[] = {0.0f, 5.0f, 10.0f, -1.0f, 11.0f, NAN};
+  rgba8888_t output[6];
+
+  ColorizeOptions options;
+  options.clamp = false;
+  options.nan_color = 0x12345678;
+  options.below_color = 0xff0000ff;
+  options.above_color = 0xffff0000;
+  const ColorizeRange range = colorize(field, 6, ColorizeRange{0.0f, 10.0f, false}, palette,
+                                       Interpolation::Linear, output, options);
+  ASSERT_FLOAT_EQ(0.0f, range.min);
+  ASSERT_FLOAT_EQ(10.0f, range.max);
+  ASSERT_EQ(0xff000000, output[0]);
+  ASSERT_EQ(0xff808080, output[1]);
+  ASSERT_EQ(0xffffffff, output[2]);
+  ASSERT_EQ(0xff0000ff, output[3]);
+  ASSERT_EQ(0xffff0000, output[4]);
+  ASSERT_EQ(0x12345678, output[5]);
+}
+
+TEST(Colorize, AutomaticRangeAndStride) {
+  const rgb888_t data[] = {0xef8a62, 0xf7f7f7, 0x67a9cf};
+  const Palette palette = create_palette(data);
+  // Only every other value is part of the field.
+  const float field[] = {2.0f, 100.0f, NAN, 100.0f, 4.0f, -100.0f, 3.0f, 0.0f};
+  rgba8888_t output[4];
+
+  ColorizeOptions options;
+  options.stride = 2;
+  const ColorizeRange range =
+      colorize(field, 4, automatic_range(), palette, Interpolation::LabLinear, output, options);
+  ASSERT_FLOAT_EQ(2.0f, range.min);
+  ASSERT_FLOAT_EQ(4.0f, range.max);
+  ASSERT_EQ(to_rgba8888(palette[0]), output[0]);
+  ASSERT_EQ(options.nan_color, output[1]);
+  ASSERT_EQ(to_rgba8888(palette[2]), output[2]);
+  ASSERT_EQ(to_rgba8888(interpolate_lab_linear(palette, 0.5f)), output[3]);
+}
+
+TEST(Colorize, ThreadsMatchSingleThread) {
+  const rgb888_t data[] = {0xef8a62, 0xf7f7f7, 0x67a9cf};
+  const Palette palette = create_palette(data);
+  const std::size_t kCount = 1 << 20;
+  std::vector<float> field(kCount);
+  for (std::size_t i = 0; i < kCount; i++) {
+    field[i] = std::sin(i * 0.001f) * 3.0f;
+  }
+
+  std::vector<rgba8888_t> single(kCount);
+  std::vector<rgba8888_t> threaded(kCount);
+  ColorizeOptions options;
+  options.threads = 1;
+  const ColorizeRange single_range = colorize(field.data(), kCount, automatic_range(), palette,
+                                              Interpolation::HslLinear, single.data(), options);
+  options.threads = 4;
+  const ColorizeRange threaded_range = colorize(field.data(), kCount, automatic_range(), palette,
+                                                Interpolation::HslLinear, threaded.data(), options);
+  ASSERT_EQ(single_range.min, threaded_range.min);
+  ASSERT_EQ(single_range.max, threaded_range.max);
+  ASSERT_EQ(single, threaded);
+}
+
+TEST(Colorize, NarrowRangeFarFromZero) {
+  const rgb888_t data[] = {0x000000, 0xffffff};
+  const Palette palette = create_palette(data);
+  const float field[] = {300000.0f, 300001.5f, 300003.0f, 1.0e6f, 1.0e6f + 1.0f};
+  rgba8888_t output[5];
+
+  colorize(field, 3, ColorizeRange{300000.0f, 300003.0f, false}, palette, Interpolation::Linear,
+           output);
+  ASSERT_EQ(0xff000000, output[0]);
+  ASSERT_EQ(0xff808080, output[1]);
+  ASSERT_EQ(0xffffffff, output[2]);
+
+  colorize(field + 3, 2, ColorizeRange{1.0e6f, 1.0e6f + 1.0f, false}, palette,
+           Interpolation::Linear, output);
+  ASSERT_EQ(0xff000000, output[0]);
+  ASSERT_EQ(0xffffffff, output[1]);
+}
+
+TEST(Colorize, Infinities) {
+  const rgb888_t data[] = {0x000000, 0xffffff};
+  const Palette palette = create_palette(data);
+  const float field[] = {-INFINITY, 0.0f, 10.0f, 5.0f, INFINITY};
+  rgba8888_t output[5];
+
+  ColorizeOptions options;
+  options.clamp = false;
+  options.below_color = 0xff0000ff;
+  options.above_color = 0xffff0000;
+  const ColorizeRange range =
+      colorize(field, 5, automatic_range(), palette, Interpolation::Linear, output, options);
+  ASSERT_FLOAT_EQ(0.0f, range.min);
+  ASSERT_FLOAT_EQ(10.0f, range.max);
+  ASSERT_EQ(0xff0000ff, output[0]);
+  ASSERT_EQ(0xff000000, output[1]);
+  ASSERT_EQ(0xffffffff, output[2]);
+  ASSERT_EQ(0xff808080, output[3]);
+  ASSERT_EQ(0xffff0000, output[4]);
+
+  // An infinite bound maps every sample inside the range onto the last entry without overflowing.
+  colorize(field, 5, ColorizeRange{0.0f, INFINITY, false}, palette, Interpolation::Linear, output,
+           options);
+  ASSERT_EQ(0xff0000ff, output[0]);
+  ASSERT_EQ(0xffffffff, output[4]);
+}
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include "test_util.hpp"
+
+#include <color/colormaps.hpp>
+#include <color/interpolation.hpp>
+#include <color/transformation.hpp>
+
+namespace color {
+
+constexpr rgb888_t kTestStops[] = {0x000000, 0xff8000};
+constexpr ColormapTable<5> kTestColormap = make_colormap<5>(kTestStops);
+static_assert(kTestColormap[2].values[0] == 0.5f, "Colormaps must be generated at compile time.");
+
+TEST(Colormaps, MakeColormap) {
+  COLOR_ASSERT_EQ(to_srgb(kTestStops[0]), kTestColormap[0]);
+  COLOR_ASSERT_EQ(to_srgb(kTestStops[1]), kTestColormap[4]);
+  COLOR_ASSERT_FLOAT_EQ((sRgb{0.25f, 0.25f * 128.0f / 255.0f, 0.0f}), kTestColormap[1]);
+}
+
+TEST(Colormaps, TablesMatchStops) {
+  ASSERT_EQ(256, kViridis256.size());
+  for (int i = 0; i < 256; i++) {
+    COLOR_ASSERT_EQ(to_srgb(kViridisStops[i]), kViridis256[i]);
+    COLOR_ASSERT_EQ(to_srgb(kTurboStops[i]), kTurbo256[i]);
+  }
+  COLOR_ASSERT_EQ(kMagma256[0], kMagma1024[0]);
+  COLOR_ASSERT_EQ(kMagma256[255], kMagma1024[1023]);
+}
+
+TEST(Colormaps, Interpolation) {
+  const Palette palette = create_palette(kInfernoStops);
+  COLOR_ASSERT_EQ(interpolate_linear(palette, 0.3f), interpolate_linear(kInferno256, 0.3f));
+}
+}
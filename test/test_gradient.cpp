@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "test_util.hpp"
+
+#include <color/gradient.hpp>
+#include <color/transformation.hpp>
+
+#include <cmath>
+
+namespace color {
+
+TEST(SplineGradient, InterpolatesPaletteColors) {
+  const rgb888_t data[] = {0xef8a62, 0xf7f7f7, 0x67a9cf, 0x2166ac};
+  const Palette palette = create_palette(data);
+  const ColorSpace spaces[] = {ColorSpace::sRgb, ColorSpace::Xyz, ColorSpace::Lab};
+  const SplineType types[] = {SplineType::CatmullRom, SplineType::MonotoneCubic};
+
+  for (ColorSpace space : spaces) {
+    for (SplineType type : types) {
+      SplineGradient gradient(palette, space, type);
+      for (int i = 0; i < 4; i++) {
+        COLOR_ASSERT_NEAR(palette[i], gradient.sample(i / 3.0f), 1.0e-4f);
+      }
+    }
+  }
+}
+
+TEST(SplineGradient, BSplineEndpoints) {
+  const rgb888_t data[] = {0x000000, 0xff0000, 0xffff00, 0xffffff};
+  const Palette palette = create_palette(data);
+  SplineGradient gradient(palette, ColorSpace::sRgb, SplineType::BSpline);
+  COLOR_ASSERT_NEAR(palette.front(), gradient.sample(0.0f), 1.0e-6f);
+  COLOR_ASSERT_NEAR(palette.back(), gradient.sample(1.0f), 1.0e-6f);
+}
+
+TEST(SplineGradient, MonotoneDoesNotOvershoot) {
+  const rgb888_t data[] = {0x000000, 0x000000, 0xffffff, 0xffffff};
+  const Palette palette = create_palette(data);
+  SplineGradient monotone(palette, ColorSpace::sRgb, SplineType::MonotoneCubic);
+
+  float previous = 0.0f;
+  for (int i = 0; i <= 300; i++) {
+    const sRgb srgb = monotone.sample(i / 300.0f);
+    ASSERT_GE(srgb.red, previous);
+    previous = srgb.red;
+  }
+  ASSERT_FLOAT_EQ(0.0f, monotone.sample(0.2f).red);
+  ASSERT_FLOAT_EQ(1.0f, monotone.sample(0.8f).red);
+}
+
+TEST(SplineGradient, SinglePaletteColor) {
+  const rgb888_t data[] = {0x67a9cf};
+  const Palette palette = create_palette(data);
+  SplineGradient gradient(palette, ColorSpace::Hsv, SplineType::CatmullRom);
+  COLOR_ASSERT_NEAR(palette[0], gradient.sample(0.0f), 1.0e-6f);
+  COLOR_ASSERT_NEAR(palette[0], gradient.sample(1.0f), 1.0e-6f);
+}
+
+TEST(SplineGradient, BatchMatchesSingleSamples) {
+  const rgb888_t data[] = {0xef8a62, 0xf7f7f7, 0x67a9cf};
+  const Palette palette = create_palette(data);
+  SplineGradient gradient(palette, ColorSpace::Hsl, SplineType::CatmullRom);
+
+  const int kCount = 17;
+  float t[kCount];
+  for (int i = 0; i < kCount; i++) {
+    t[i] = i / float(kCount - 1);
+  }
+  sRgb batch[kCount];
+  sRgb uniform[kCount];
+  gradient.sample(t, kCount, batch);
+  gradient.sample_uniform(kCount, uniform);
+  for (int i = 0; i < kCount; i++) {
+    COLOR_ASSERT_EQ(gradient.sample(t[i]), batch[i]);
+    COLOR_ASSERT_NEAR(batch[i], uniform[i], 1.0e-6f);
+  }
+}
+
+TEST(HueGradient, Directions) {
+  const rgb888_t data[] = {0xff0000, 0xff00ff};
+  const Palette palette = create_palette(data);
+
+  // Red to magenta is a sixth of a turn backwards, or five sixths forwards.
+  HueGradient shortest(palette, HueSpace::Hsv, HueDirection::Shortest);
+  COLOR_ASSERT_NEAR((sRgb{1.0f, 0.0f, 0.5f}), shortest.sample(0.5f), 1.0e-6f);
+  HueGradient decreasing(palette, HueSpace::Hsv, HueDirection::Decreasing);
+  COLOR_ASSERT_NEAR(shortest.sample(0.5f), decreasing.sample(0.5f), 1.0e-6f);
+
+  HueGradient longest(palette, HueSpace::Hsl, HueDirection::Longest);
+  COLOR_ASSERT_NEAR((sRgb{0.0f, 1.0f, 0.5f}), longest.sample(0.5f), 1.0e-6f);
+  HueGradient increasing(palette, HueSpace::Hsl, HueDirection::Increasing);
+  COLOR_ASSERT_NEAR(longest.sample(0.5f), increasing.sample(0.5f), 1.0e-6f);
+
+  COLOR_ASSERT_NEAR(palette[0], shortest.sample(0.0f), 1.0e-6f);
+  COLOR_ASSERT_NEAR(palette[1], longest.sample(1.0f), 1.0e-6f);
+}
+
+TEST(HueGradient, AchromaticKeepsHue) {
+  const rgb888_t data[] = {0xffffff, 0x0000ff};
+  const Palette palette = create_palette(data);
+  HueGradient gradient(palette, HueSpace::Hsv, HueDirection::Shortest);
+  COLOR_ASSERT_NEAR((sRgb{0.5f, 0.5f, 1.0f}), gradient.sample(0.5f), 1.0e-6f);
+}
+
+static float delta_e(const sRgb& a, const sRgb& b) {
+  const Lab lab_a = to_lab(to_xyz(a));
+  const Lab lab_b = to_lab(to_xyz(b));
+  float distance = 0.0f;
+  for (int c = 0; c < 3; c++) {
+    distance += (lab_a.values[c] - lab_b.values[c]) * (lab_a.values[c] - lab_b.values[c]);
+  }
+  return std::sqrt(distance);
+}
+
+TEST(UniformGradient, EqualPerceptualSteps) {
+  // The first segment covers far less of the lightness range than the others.
+  const rgb888_t data[] = {0x000000, 0x101010, 0x808080, 0xffffff};
+  const Palette palette = create_palette(data);
+  UniformGradient gradient(palette, 1024);
+
+  const int kCount = 9;
+  const Palette uniform = create_uniform_palette(palette, kCount);
+  ASSERT_EQ(kCount, uniform.size());
+  COLOR_ASSERT_NEAR(palette.front(), uniform.front(), 1.0e-5f);
+  COLOR_ASSERT_NEAR(palette.back(), uniform.back(), 1.0e-5f);
+
+  // Walk the gradient finely so the measured arc length follows the path around each stop.
+  const int kSubdivisions = 64;
+  float arc_length = 0.0f;
+  sRgb previous = gradient.sample(0.0f);
+  for (int i = 1; i < kCount; i++) {
+    for (int j = 1; j <= kSubdivisions; j++) {
+      const sRgb next = gradient.sample((i - 1 + j / float(kSubdivisions)) / (kCount - 1));
+      arc_length += delta_e(previous, next);
+      previous = next;
+    }
+    COLOR_ASSERT_NEAR(uniform[i], previous, 1.0e-5f);
+    ASSERT_NEAR(gradient.length() * i / (kCount - 1), arc_length, 0.01f * gradient.length());
+  }
+}
+
+TEST(UniformGradient, RepeatedColor) {
+  const rgb888_t data[] = {0x67a9cf, 0x67a9cf};
+  const Palette palette = create_palette(data);
+  UniformGradient gradient(palette);
+  ASSERT_FLOAT_EQ(0.0f, gradient.length());
+  COLOR_ASSERT_NEAR(palette[0], gradient.sample(0.5f), 1.0e-5f);
+}
+}
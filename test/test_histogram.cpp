@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <color/histogram.hpp>
+#include <color/transformation.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace color {
+
+TEST(Histogram, HueBins) {
+  // Red, yellow, green, cyan, blue and magenta each fall in their own sixth of the hue circle.
+  const rgb888_t pixels[] = {0xff0000, 0xffff00, 0x00ff00, 0x00ffff, 0x0000ff, 0xff00ff, 0xff0000};
+  const HistogramBinning binning = create_binning(ColorSpace::Hsv, 6, 1, 1);
+  const Histogram histogram = build_histogram(pixels, 7, binning);
+
+  // The hue bins are followed by a single bin for achromatic colors.
+  ASSERT_EQ(6 + 1, histogram.size());
+  ASSERT_EQ(7, histogram.total());
+  ASSERT_EQ(0, histogram.achromatic());
+  ASSERT_EQ(2, histogram.count(0, 0, 0));
+  for (int i = 1; i < 6; i++) {
+    ASSERT_EQ(1, histogram.count(i, 0, 0));
+  }
+}
+
+TEST(Histogram, AchromaticColors) {
+  const rgb888_t pixels[] = {0x000000, 0x808080, 0xffffff, 0xff0000, 0xf0e0e0};
+  HistogramBinning binning = create_binning(ColorSpace::Hsl, 6, 1, 1);
+  Histogram histogram = build_histogram(pixels, 5, binning);
+  ASSERT_EQ(5, histogram.total());
+  ASSERT_EQ(3, histogram.achromatic());
+  ASSERT_EQ(2, histogram.count(0, 0, 0));
+
+  // A threshold also moves nearly gray colors out of the hue bins.
+  binning.achromatic_saturation = 0.6f;
+  const HistogramBinMap map(binning);
+  histogram = build_histogram(pixels, 5, map);
+  ASSERT_EQ(4, histogram.achromatic());
+  ASSERT_EQ(1, histogram.count(0, 0, 0));
+}
+
+TEST(Histogram, AchromaticLightness) {
+  // Without hue bins, grays are binned by lightness like any other color.
+  const rgb888_t pixels[] = {0x000000, 0x606060, 0xa0a0a0, 0xffffff, 0xff0000};
+  const HistogramBinning binning = create_binning(ColorSpace::Hsl, 1, 1, 4);
+  const Histogram histogram = build_histogram(pixels, 5, binning);
+  ASSERT_EQ(4, histogram.size());
+  ASSERT_EQ(0, histogram.achromatic());
+  const uint64_t kCounts[] = {1, 1, 2, 1};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(kCounts[i], histogram.count(0, 0, i));
+  }
+
+  // With hue bins, grays are counted apart from them but keep their lightness bin.
+  const HistogramBinning hue_binning = create_binning(ColorSpace::Hsl, 6, 1, 4);
+  const Histogram hue_histogram = build_histogram(pixels, 5, HistogramBinMap(hue_binning));
+  ASSERT_EQ(6 * 4 + 4, hue_histogram.size());
+  ASSERT_EQ(5, hue_histogram.total());
+  ASSERT_EQ(4, hue_histogram.achromatic());
+  ASSERT_EQ(1, hue_histogram.count(0, 0, 2));
+  const uint64_t kAchromaticCounts[] = {1, 1, 1, 1};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(kAchromaticCounts[i], hue_histogram.achromatic_count(0, i));
+  }
+}
+
+TEST(Histogram, NanComponents) {
+  const HistogramBinning binning = create_binning(ColorSpace::sRgb, 4, 4, 4);
+  const float values[3] = {NAN, 1.0e30f, -1.0e30f};
+  ASSERT_EQ(0 * 16 + 3 * 4 + 0, find_bin(binning, values));
+}
+
+TEST(Histogram, LabBins) {
+  const HistogramBinning binning = create_binning(ColorSpace::Lab, 4, 2, 2);
+  const float black[3] = {0.0f, 0.0f, 0.0f};
+  const float white[3] = {100.0f, 0.0f, 0.0f};
+  const float outside[3] = {50.0f, -200.0f, 200.0f};
+  ASSERT_EQ(find_bin(binning, black), 0 * 4 + 1 * 2 + 1);
+  ASSERT_EQ(find_bin(binning, white), 3 * 4 + 1 * 2 + 1);
+  ASSERT_EQ(find_bin(binning, outside), 2 * 4 + 0 * 2 + 1);
+}
+
+TEST(Histogram, ThreadsAndBinMapMatch) {
+  const std::size_t kCount = 1 << 18;
+  std::vector<rgb888_t> pixels(kCount);
+  std::vector<sRgb> srgb_pixels(kCount);
+  for (std::size_t i = 0; i < kCount; i++) {
+    pixels[i] = rgb888_t((i * 2654435761u) & 0xffffff);
+    srgb_pixels[i] = to_srgb(pixels[i]);
+  }
+
+  const HistogramBinning binning = create_binning(ColorSpace::Lab, 8, 8, 8);
+  const Histogram single = build_histogram(pixels.data(), kCount, binning, 1);
+  const Histogram threaded = build_histogram(pixels.data(), kCount, binning, 4);
+  const Histogram srgb = build_histogram(srgb_pixels.data(), kCount, binning, 3);
+  const HistogramBinMap map(binning);
+  const Histogram mapped = build_histogram(pixels.data(), kCount, map, 4);
+
+  ASSERT_EQ(kCount, single.total());
+  ASSERT_EQ(single.counts(), threaded.counts());
+  ASSERT_EQ(single.counts(), srgb.counts());
+  ASSERT_EQ(single.counts(), mapped.counts());
+}
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <color/transformation.hpp>
+#include <tools/image_stream.hpp>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace color {
+
+namespace tool {
+
+static const uint8_t* bytes_of(const std::string& text) {
+  return reinterpret_cast<const uint8_t*>(text.data());
+}
+
+// Convert an image into a temporary file and read back the float components.
+static std::vector<float> convert(const Image& image, const Conversion& conversion,
+                                  bool output_bottom_up) {
+  std::FILE* file = std::tmpfile();
+  EXPECT_NE(nullptr, file);
+  Converter converter(image, conversion, fileno(file), 0, output_bottom_up, false);
+  EXPECT_TRUE(converter.run());
+  std::vector<float> output(3 * image.width * image.height);
+  const ssize_t bytes = ssize_t(output.size() * sizeof(float));
+  EXPECT_EQ(bytes, pread(fileno(file), output.data(), std::size_t(bytes), 0));
+  std::fclose(file);
+  return output;
+}
+
+TEST(ImageStream, ParsePpm) {
+  const std::string data = "P6\n# A comment\n4 2\n255\n" + std::string(24, '\x80');
+  Image image;
+  std::string error;
+  ASSERT_TRUE(parse_image(bytes_of(data), data.size(), &image, &error));
+  ASSERT_EQ(4, image.width);
+  ASSERT_EQ(2, image.height);
+  ASSERT_EQ(3, image.channels);
+  ASSERT_EQ(SampleType::UInt8, image.type);
+  ASSERT_FALSE(image.bottom_up);
+  ASSERT_EQ(bytes_of(data) + data.size() - 24, image.pixels);
+
+  const std::string wide = "P6 1 1 65535\n\x12\x34";
+  ASSERT_TRUE(parse_image(bytes_of(wide), wide.size(), &image, &error));
+  ASSERT_EQ(SampleType::UInt16, image.type);
+  // 16-bit samples are big endian whatever the host.
+  ASSERT_EQ(0x1234 / 65535.0f, read_sample(image.pixels, image.type, image.swap_bytes));
+}
+
+TEST(ImageStream, ParsePamAndPfm) {
+  const std::string pam =
+      "P7\nWIDTH 3\nHEIGHT 5\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+  Image image;
+  std::string error;
+  ASSERT_TRUE(parse_image(bytes_of(pam), pam.size(), &image, &error));
+  ASSERT_EQ(3, image.width);
+  ASSERT_EQ(5, image.height);
+  ASSERT_EQ(4, image.channels);
+
+  const float value = 0.25f;
+  std::string pfm = "PF\n1 1\n-1.0\n" + std::string(12, '\0');
+  uint8_t little_endian[4];
+  std::memcpy(little_endian, &value, 4);
+  if (!host_is_little_endian()) {
+    std::swap(little_endian[0], little_endian[3]);
+    std::swap(little_endian[1], little_endian[2]);
+  }
+  pfm.replace(pfm.size() - 12, 4, reinterpret_cast<const char*>(little_endian), 4);
+  ASSERT_TRUE(parse_image(bytes_of(pfm), pfm.size(), &image, &error));
+  ASSERT_EQ(SampleType::Float32, image.type);
+  ASSERT_TRUE(image.bottom_up);
+  ASSERT_EQ(value, read_sample(image.pixels, image.type, image.swap_bytes));
+}
+
+TEST(ImageStream, MalformedHeaders) {
+  const char* kHeaders[] = {"P5\n1 1\n255\n", "P6\n1 1\n1023\n", "P6\n-1 1\n255\n",
+                            "P6\n1 1 255", "P7\nWIDTH 1\nHEIGHT 1\nDEPTH 1\nMAXVAL 255\nENDHDR\n",
+                            "PF\n1 1\n"};
+  for (const char* header : kHeaders) {
+    const std::string data = header;
+    Image image;
+    std::string error;
+    ASSERT_FALSE(parse_image(bytes_of(data), data.size(), &image, &error)) << header;
+    ASSERT_FALSE(error.empty());
+  }
+}
+
+TEST(ImageStream, OversizedImages) {
+  const std::string data = "P6\n6148914691236517206 1\n255\n";
+  Image image;
+  std::string error;
+  ASSERT_TRUE(parse_image(bytes_of(data), data.size(), &image, &error));
+  std::size_t bytes;
+  ASSERT_FALSE(image_bytes(image, &bytes));
+
+  image.width = 3;
+  image.height = 2;
+  ASSERT_TRUE(image_bytes(image, &bytes));
+  ASSERT_EQ(18, bytes);
+}
+
+TEST(ImageStream, InputPixel) {
+  const Image image{3, 2, 3, SampleType::Float32, false, true, nullptr};
+  for (std::size_t pixel = 0; pixel < 6; pixel++) {
+    ASSERT_EQ(pixel, input_pixel(image, true, pixel));
+  }
+  const std::size_t kReversed[] = {3, 4, 5, 0, 1, 2};
+  for (std::size_t pixel = 0; pixel < 6; pixel++) {
+    ASSERT_EQ(kReversed[pixel], input_pixel(image, false, pixel));
+  }
+}
+
+TEST(ImageStream, ConvertChunksAcrossRows) {
+  // Chunks end part way through a row in both images, and the single row is wider than a chunk.
+  const std::size_t kShapes[][2] = {{1000, 300}, {Converter::kChunkPixels + 1000, 1}};
+  for (const auto& shape : kShapes) {
+    const std::size_t width = shape[0];
+    const std::size_t height = shape[1];
+    std::vector<uint8_t> pixels(3 * width * height);
+    for (std::size_t i = 0; i < pixels.size(); i++) {
+      pixels[i] = uint8_t(i * 7 + i / 3000);
+    }
+    const Image image{width, height, 3, SampleType::UInt8, false, false, pixels.data()};
+
+    for (bool use_cache : {false, true}) {
+      const Conversion conversion{ColorSpace::sRgb, ColorSpace::Lab, 4, use_cache};
+      const std::vector<float> output = convert(image, conversion, false);
+      for (std::size_t pixel = 0; pixel < width * height; pixel += 997) {
+        const uint8_t* input = &pixels[3 * pixel];
+        float expected[3];
+        to_space(to_srgb((rgb888_t(input[0]) << 16) | (rgb888_t(input[1]) << 8) | input[2]),
+                 ColorSpace::Lab, expected);
+        for (int c = 0; c < 3; c++) {
+          ASSERT_NEAR(expected[c], output[3 * pixel + c], 1e-4f);
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageStream, ConvertReversedRows) {
+  const std::size_t width = 700;
+  const std::size_t height = 400;
+  std::vector<float> pixels(3 * width * height);
+  for (std::size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = float(i % 1001) / 1000.0f;
+  }
+  const Image image{width,
+                    height,
+                    3,
+                    SampleType::Float32,
+                    false,
+                    true,
+                    reinterpret_cast<const uint8_t*>(pixels.data())};
+
+  const Conversion conversion{ColorSpace::sRgb, ColorSpace::Hsv, 3, false};
+  const std::vector<float> output = convert(image, conversion, false);
+  for (std::size_t pixel = 0; pixel < width * height; pixel += 331) {
+    const std::size_t row = pixel / width;
+    const std::size_t column = pixel % width;
+    const float* input = &pixels[3 * ((height - 1 - row) * width + column)];
+    float expected[3];
+    to_space(from_space(input, ColorSpace::sRgb), ColorSpace::Hsv, expected);
+    for (int c = 0; c < 3; c++) {
+      ASSERT_NEAR(expected[c], output[3 * pixel + c], 1e-4f);
+    }
+  }
+}
+
+} // namespace tool
+
+} // namespace color
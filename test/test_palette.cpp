@@ -2,7 +2,9 @@
 
 #include "test_util.hpp"
 
+#include <color/interpolation.hpp>
 #include <color/palette.hpp>
+#include <color/transformation.hpp>
 
 namespace color {
 TEST(Palette, CreatePointerAndSize) {
@@ -32,4 +34,37 @@ TEST(Palette, CreateArray) {
     COLOR_ASSERT_FLOAT_EQ(colors[i], palette[i]);
   }
 }
+
+TEST(Palette, CreateInStorage) {
+  const int kSize = 3;
+  const rgb888_t data[kSize] = {0xef8a62, 0xf7f7f7, 0x67a9cf};
+  sRgb storage[kSize];
+
+  PaletteView view = create_palette(data, kSize, storage);
+  ASSERT_EQ(kSize, view.size());
+  ASSERT_EQ(storage, view.data());
+  for (int i = 0; i < kSize; i++) {
+    COLOR_ASSERT_EQ(to_srgb(data[i]), view[i]);
+  }
+}
+
+TEST(Palette, InlinePalette) {
+  const rgb888_t data[] = {0xef8a62, 0xf7f7f7, 0x67a9cf};
+  InlinePalette<3> palette = create_inline_palette(data);
+  ASSERT_EQ(3, palette.size());
+  ASSERT_FALSE(palette.push_back(to_srgb(0x000000)));
+
+  const Palette expected = create_palette(data);
+  for (int i = 0; i < 3; i++) {
+    COLOR_ASSERT_EQ(expected[i], palette[i]);
+  }
+  COLOR_ASSERT_EQ(interpolate_lab_linear(expected, 0.3f), interpolate_lab_linear(palette, 0.3f));
+}
+
+TEST(Palette, ViewOfArray) {
+  const sRgb colors[] = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+  PaletteView view(colors);
+  ASSERT_EQ(2, view.size());
+  COLOR_ASSERT_EQ((sRgb{0.5f, 0.5f, 0.5f}), interpolate_linear(view, 0.5f));
+}
 }
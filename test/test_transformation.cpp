@@ -95,6 +95,15 @@ TEST(sRgb, Conversions) {
   COLOR_ASSERT_FLOAT_EQ(srgb_black, to_srgb(to_xyz(lab_black)));
 }
 
+TEST(Rgba8888, Conversions) {
+  ASSERT_EQ(0xff80ff00, to_rgba8888(sRgb{0.0f, 1.0f, 0.5f}));
+  ASSERT_EQ(0x40302010, to_rgba8888(to_srgb(0x102030), 0x40));
+
+  // Channels outside of [0, 1] are clamped rather than wrapping around.
+  ASSERT_EQ(0xff8000ff, to_rgba8888(sRgb{1.01f, -0.01f, 0.5f}));
+  ASSERT_EQ(0xffff00ff, to_rgba8888(sRgb{100.0f, -100.0f, 2.0f}));
+}
+
 TEST(Hsl, Conversions) {
   sRgb srgb = to_srgb(0x267fd9);
   Hsl hsl;
@@ -0,0 +1,201 @@
+// Convert the pixels of an image between color spaces, writing the components as 32-bit floats.
+//
+// Usage:
+//  color_convert [--from SPACE] --to SPACE [--threads N] [--cache]
+//                [--raw WIDTHxHEIGHT --raw-type u8|u16|f32] INPUT OUTPUT
+//
+// INPUT is a binary PPM (P6), PAM (P7) with three or four channels, PFM (PF) or, with --raw,
+// headerless interleaved RGB samples in host byte order. Integer samples are scaled into [0, 1].
+// Any alpha channel is dropped. OUTPUT is written as a PFM if its name ends in .pfm and as raw
+// interleaved floats otherwise.
+//
+// The input is memory mapped and converted in fixed-size chunks of pixels, each split across
+// threads, while the previous chunk is written from a second buffer. Input pages are released once
+// converted, so peak memory is independent of the image size and shape.
+
+#include "image_stream.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace color;
+using namespace color::tool;
+
+// A read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  MappedFile() : data_(nullptr), size_(0) {}
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+  }
+
+  bool open(const char* path) {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat info;
+    const bool has_size = fstat(fd, &info) == 0;
+    if (!has_size || info.st_size == 0) {
+      // An empty file cannot be mapped, so report it the way mmap would.
+      const int error = has_size ? EINVAL : errno;
+      close(fd);
+      errno = error;
+      return false;
+    }
+    size_ = std::size_t(info.st_size);
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    close(fd);
+    if (data == MAP_FAILED) {
+      errno = error;
+      return false;
+    }
+    // The file is read once, so let the kernel read ahead. MADV_SEQUENTIAL alone does not keep the
+    // converted pages from staying resident, so the Converter releases them as it goes.
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(data);
+    return true;
+  }
+
+  const uint8_t* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  const uint8_t* data_;
+  std::size_t size_;
+};
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int usage() {
+  std::fprintf(stderr,
+               "Usage: color_convert [--from SPACE] --to SPACE [--threads N] [--cache]\n"
+               "                     [--raw WIDTHxHEIGHT --raw-type u8|u16|f32] INPUT OUTPUT\n"
+               "SPACE is one of srgb, hsv, hsl, xyz or lab.\n"
+               "--raw u16 and f32 samples are read in host byte order.\n");
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Conversion conversion{ColorSpace::sRgb, ColorSpace::sRgb, 0, false};
+  bool has_to = false;
+  bool raw = false;
+  Image image{0, 0, 3, SampleType::UInt8, false, false, nullptr};
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--from" && has_value) {
+      if (!parse_space(argv[++i], &conversion.from)) {
+        return usage();
+      }
+    } else if (arg == "--to" && has_value) {
+      if (!parse_space(argv[++i], &conversion.to)) {
+        return usage();
+      }
+      has_to = true;
+    } else if (arg == "--threads" && has_value) {
+      conversion.threads = unsigned(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--cache") {
+      conversion.use_cache = true;
+    } else if (arg == "--raw" && has_value) {
+      unsigned long width = 0;
+      unsigned long height = 0;
+      if (std::sscanf(argv[++i], "%lux%lu", &width, &height) != 2) {
+        return usage();
+      }
+      image.width = width;
+      image.height = height;
+      raw = true;
+    } else if (arg == "--raw-type" && has_value) {
+      const std::string type = argv[++i];
+      if (type == "u8") {
+        image.type = SampleType::UInt8;
+      } else if (type == "u16") {
+        image.type = SampleType::UInt16;
+      } else if (type == "f32") {
+        image.type = SampleType::Float32;
+      } else {
+        return usage();
+      }
+    } else if (arg.compare(0, 2, "--") != 0) {
+      paths.push_back(argv[i]);
+    } else {
+      return usage();
+    }
+  }
+  if (!has_to || paths.size() != 2) {
+    return usage();
+  }
+
+  MappedFile input;
+  if (!input.open(paths[0])) {
+    std::fprintf(stderr, "Unable to map %s: %s\n", paths[0], std::strerror(errno));
+    return 1;
+  }
+  std::string error;
+  if (raw) {
+    image.pixels = input.data();
+  } else if (!parse_image(input.data(), input.size(), &image, &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  const std::size_t header_size = std::size_t(image.pixels - input.data());
+  std::size_t pixel_bytes;
+  if (!image_bytes(image, &pixel_bytes)) {
+    std::fprintf(stderr, "%s has an unsupported %zux%zu image size.\n", paths[0], image.width,
+                 image.height);
+    return 1;
+  }
+  if (image.width == 0 || image.height == 0 || input.size() - header_size < pixel_bytes) {
+    std::fprintf(stderr, "%s is smaller than its %zux%zu image.\n", paths[0], image.width,
+                 image.height);
+    return 1;
+  }
+
+  const std::string output_path = paths[1];
+  const bool pfm = ends_with(output_path, ".pfm");
+  std::string header;
+  if (pfm) {
+    header = "PF\n" + std::to_string(image.width) + " " + std::to_string(image.height) + "\n" +
+             (host_is_little_endian() ? "-1.0\n" : "1.0\n");
+  }
+
+  const int output_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (output_fd < 0) {
+    std::fprintf(stderr, "Unable to open %s: %s\n", output_path.c_str(), std::strerror(errno));
+    return 1;
+  }
+  bool ok = pwrite(output_fd, header.data(), header.size(), 0) == ssize_t(header.size());
+  if (ok) {
+    Converter converter(image, conversion, output_fd, off_t(header.size()), pfm, true);
+    ok = converter.run();
+  }
+  ok = (close(output_fd) == 0) && ok;
+  if (!ok) {
+    std::fprintf(stderr, "Unable to write %s.\n", output_path.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,402 @@
+#include "image_stream.hpp"
+
+#include <color/internal/math.hpp>
+#include <color/internal/parallel.hpp>
+#include <color/transformation.hpp>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace color {
+
+namespace tool {
+
+// Pixels are decoded this many at a time so each batch stays in the L1 cache.
+static const std::size_t kBatchPixels = 256;
+
+const std::size_t Converter::kChunkPixels;
+
+bool host_is_little_endian() {
+  const uint16_t value = 1;
+  uint8_t first;
+  std::memcpy(&first, &value, 1);
+  return first == 1;
+}
+
+std::size_t sample_size(SampleType type) {
+  switch (type) {
+  case SampleType::UInt8:
+    return 1;
+  case SampleType::UInt16:
+    return 2;
+  case SampleType::Float32:
+    return 4;
+  }
+  return 1;
+}
+
+bool parse_space(const char* name, ColorSpace* space) {
+  const struct {
+    const char* name;
+    ColorSpace space;
+  } kSpaces[] = {{"srgb", ColorSpace::sRgb},
+                 {"hsv", ColorSpace::Hsv},
+                 {"hsl", ColorSpace::Hsl},
+                 {"xyz", ColorSpace::Xyz},
+                 {"lab", ColorSpace::Lab}};
+  for (const auto& entry : kSpaces) {
+    if (std::strcmp(name, entry.name) == 0) {
+      *space = entry.space;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads whitespace separated tokens from a Netpbm header, skipping comments.
+class HeaderReader {
+public:
+  HeaderReader(const uint8_t* data, std::size_t size) : data_(data), size_(size), offset_(0) {}
+
+  std::string token() {
+    skip_whitespace();
+    std::string token;
+    while (offset_ < size_ && !is_space(data_[offset_])) {
+      token += char(data_[offset_++]);
+    }
+    return token;
+  }
+
+  bool number(std::size_t* value) {
+    const std::string text = token();
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+      return false;
+    }
+    errno = 0;
+    *value = std::size_t(std::strtoull(text.c_str(), nullptr, 10));
+    return errno == 0;
+  }
+
+  // Consume the single whitespace character that separates the header from the pixels.
+  bool end_header() {
+    if (offset_ >= size_ || !is_space(data_[offset_])) {
+      return false;
+    }
+    offset_++;
+    return true;
+  }
+
+  std::size_t offset() const { return offset_; }
+
+private:
+  static bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+  void skip_whitespace() {
+    while (offset_ < size_) {
+      if (data_[offset_] == '#') {
+        while (offset_ < size_ && data_[offset_] != '\n') {
+          offset_++;
+        }
+      } else if (is_space(data_[offset_])) {
+        offset_++;
+      } else {
+        break;
+      }
+    }
+  }
+
+  const uint8_t* data_;
+  std::size_t size_;
+  std::size_t offset_;
+};
+
+static bool set_max_value(std::size_t max_value, Image* image, std::string* error) {
+  if (max_value == 255) {
+    image->type = SampleType::UInt8;
+  } else if (max_value == 65535) {
+    // 16-bit Netpbm samples are big endian.
+    image->type = SampleType::UInt16;
+    image->swap_bytes = host_is_little_endian();
+  } else {
+    *error = "Only 8 and 16-bit samples with full range are supported.";
+    return false;
+  }
+  return true;
+}
+
+static bool parse_ppm(HeaderReader* reader, Image* image, std::string* error) {
+  std::size_t max_value;
+  if (!reader->number(&image->width) || !reader->number(&image->height) ||
+      !reader->number(&max_value) || !reader->end_header()) {
+    *error = "Malformed PPM header.";
+    return false;
+  }
+  image->channels = 3;
+  return set_max_value(max_value, image, error);
+}
+
+static bool parse_pam(HeaderReader* reader, Image* image, std::string* error) {
+  std::size_t max_value = 0;
+  image->channels = 0;
+  for (std::string key = reader->token(); key != "ENDHDR"; key = reader->token()) {
+    bool ok = true;
+    if (key.empty()) {
+      ok = false;
+    } else if (key == "WIDTH") {
+      ok = reader->number(&image->width);
+    } else if (key == "HEIGHT") {
+      ok = reader->number(&image->height);
+    } else if (key == "DEPTH") {
+      ok = reader->number(&image->channels);
+    } else if (key == "MAXVAL") {
+      ok = reader->number(&max_value);
+    } else if (key == "TUPLTYPE") {
+      reader->token();
+    }
+    if (!ok) {
+      *error = "Malformed PAM header.";
+      return false;
+    }
+  }
+  if (!reader->end_header() || (image->channels != 3 && image->channels != 4)) {
+    *error = "Only PAM images with three or four channels are supported.";
+    return false;
+  }
+  return set_max_value(max_value, image, error);
+}
+
+static bool parse_pfm(HeaderReader* reader, Image* image, std::string* error) {
+  const bool width_ok = reader->number(&image->width);
+  const bool height_ok = reader->number(&image->height);
+  const std::string scale = reader->token();
+  if (!width_ok || !height_ok || scale.empty() || !reader->end_header()) {
+    *error = "Malformed PFM header.";
+    return false;
+  }
+  // A negative scale marks little endian samples.
+  const bool little_endian = scale[0] == '-';
+  image->channels = 3;
+  image->type = SampleType::Float32;
+  image->swap_bytes = little_endian != host_is_little_endian();
+  image->bottom_up = true;
+  return true;
+}
+
+bool parse_image(const uint8_t* data, std::size_t size, Image* image, std::string* error) {
+  HeaderReader reader(data, size);
+  const std::string magic = reader.token();
+  image->width = 0;
+  image->height = 0;
+  image->swap_bytes = false;
+  image->bottom_up = false;
+  bool parsed = false;
+  if (magic == "P6") {
+    parsed = parse_ppm(&reader, image, error);
+  } else if (magic == "P7") {
+    parsed = parse_pam(&reader, image, error);
+  } else if (magic == "PF") {
+    parsed = parse_pfm(&reader, image, error);
+  } else {
+    *error = "Unsupported image format; use --raw for headerless input.";
+  }
+  image->pixels = data + reader.offset();
+  return parsed;
+}
+
+static bool checked_multiply(std::size_t a, std::size_t b, std::size_t* product) {
+  if (a != 0 && b > SIZE_MAX / a) {
+    return false;
+  }
+  *product = a * b;
+  return true;
+}
+
+bool image_bytes(const Image& image, std::size_t* bytes) {
+  std::size_t pixels;
+  std::size_t pixel_size;
+  return checked_multiply(image.width, image.height, &pixels) &&
+         checked_multiply(image.channels, sample_size(image.type), &pixel_size) &&
+         checked_multiply(pixels, pixel_size, bytes) &&
+         // The float output of three components per pixel must be addressable as well.
+         checked_multiply(pixels, 3 * sizeof(float), &pixel_size);
+}
+
+float read_sample(const uint8_t* data, SampleType type, bool swap_bytes) {
+  uint8_t bytes[4];
+  const std::size_t size = sample_size(type);
+  for (std::size_t i = 0; i < size; i++) {
+    bytes[i] = data[swap_bytes ? size - 1 - i : i];
+  }
+  switch (type) {
+  case SampleType::UInt8:
+    return bytes[0] / 255.0f;
+  case SampleType::UInt16: {
+    uint16_t value;
+    std::memcpy(&value, bytes, 2);
+    return value / 65535.0f;
+  }
+  case SampleType::Float32: {
+    float value;
+    std::memcpy(&value, bytes, 4);
+    return value;
+  }
+  }
+  return 0.0f;
+}
+
+std::size_t input_pixel(const Image& image, bool output_bottom_up, std::size_t output_pixel) {
+  if (image.bottom_up == output_bottom_up) {
+    return output_pixel;
+  }
+  const std::size_t row = output_pixel / image.width;
+  const std::size_t column = output_pixel % image.width;
+  return (image.height - 1 - row) * image.width + column;
+}
+
+Converter::Converter(const Image& image, const Conversion& conversion, int output_fd,
+                     off_t output_offset, bool output_bottom_up, bool release_input)
+    : image_(image), conversion_(conversion), output_fd_(output_fd), output_offset_(output_offset),
+      output_bottom_up_(output_bottom_up), release_input_(release_input), released_begin_(0),
+      released_end_(0), write_failed_(false) {
+  const std::size_t pixels = image.width * image.height;
+  for (std::vector<float>& buffer : buffers_) {
+    buffer.resize(3 * internal::min(kChunkPixels, pixels));
+  }
+  if (image.bottom_up != output_bottom_up) {
+    // Reversed rows are read from the end of the input towards the start.
+    released_begin_ = released_end_ = pixels * image.channels * sample_size(image.type);
+  }
+  if (conversion.use_cache) {
+    caches_.assign(internal::resolve_thread_count(conversion.threads),
+                   ConversionCache(conversion.to));
+  }
+}
+
+bool Converter::run() {
+  const std::size_t pixels = image_.width * image_.height;
+  std::thread writer;
+  std::size_t chunk = 0;
+  for (std::size_t first = 0; first < pixels; first += kChunkPixels, chunk++) {
+    const std::size_t count = internal::min(kChunkPixels, pixels - first);
+    // The writer that last used this buffer was joined before the previous chunk was handed off.
+    std::vector<float>& buffer = buffers_[chunk % 2];
+    convert_chunk(first, count, buffer.data());
+    if (release_input_) {
+      release_consumed_input(first + count);
+    }
+
+    if (writer.joinable()) {
+      writer.join();
+    }
+    const std::size_t bytes = 3 * sizeof(float) * count;
+    const off_t offset = output_offset_ + off_t(3 * sizeof(float) * first);
+    const float* data = buffer.data();
+    writer = std::thread([this, data, bytes, offset] { write_all(data, bytes, offset); });
+  }
+  if (writer.joinable()) {
+    writer.join();
+  }
+  return !write_failed_;
+}
+
+void Converter::convert_chunk(std::size_t first_pixel, std::size_t count, float* output) {
+  const bool reversed = image_.bottom_up != output_bottom_up_;
+  const std::size_t width = image_.width;
+  const std::size_t chunks = internal::parallel_chunk_count(count, kBatchPixels,
+                                                            conversion_.threads);
+  internal::parallel_for_chunks(count, chunks, [&](std::size_t chunk, std::size_t begin,
+                                                   std::size_t end) {
+    ConversionCache* cache = caches_.empty() ? nullptr : &caches_[chunk];
+    for (std::size_t i = begin; i < end;) {
+      // With reversed rows the input is only contiguous up to the end of each row.
+      const std::size_t pixel = first_pixel + i;
+      const std::size_t run = reversed ? width - pixel % width : end - i;
+      const std::size_t batch = internal::min(end - i, run, kBatchPixels);
+      convert_pixels(input_pixel(image_, output_bottom_up_, pixel), batch, output + 3 * i, cache);
+      i += batch;
+    }
+  });
+}
+
+void Converter::convert_pixels(std::size_t first_pixel, std::size_t count, float* output,
+                               ConversionCache* cache) const {
+  const std::size_t size = sample_size(image_.type);
+  const std::size_t stride = image_.channels * size;
+  const uint8_t* input = image_.pixels + first_pixel * stride;
+
+  if (image_.type == SampleType::UInt8 && conversion_.from == ColorSpace::sRgb) {
+    rgb888_t colors[kBatchPixels];
+    for (std::size_t i = 0; i < count; i++) {
+      const uint8_t* pixel = input + i * stride;
+      colors[i] = (rgb888_t(pixel[0]) << 16) | (rgb888_t(pixel[1]) << 8) | pixel[2];
+    }
+    to_space(colors, count, conversion_.to, output, cache);
+    return;
+  }
+
+  sRgb colors[kBatchPixels];
+  for (std::size_t i = 0; i < count; i++) {
+    float values[3];
+    for (int c = 0; c < 3; c++) {
+      values[c] = read_sample(input + i * stride + c * size, image_.type, image_.swap_bytes);
+    }
+    colors[i] = from_space(values, conversion_.from);
+  }
+  to_space(colors, count, conversion_.to, output);
+}
+
+// Release the whole pages of input that every output pixel before end_pixel has finished reading.
+void Converter::release_consumed_input(std::size_t end_pixel) {
+  const std::size_t stride = image_.channels * sample_size(image_.type);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(image_.pixels);
+  const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+
+  if (image_.bottom_up == output_bottom_up_) {
+    // The input is consumed from the start up to the same pixel.
+    const uintptr_t end = (base + end_pixel * stride) / page * page;
+    const uintptr_t begin = (base + released_end_ + page - 1) / page * page;
+    if (end > begin) {
+      madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+      released_end_ = end - base;
+    }
+  } else {
+    // The input is consumed from the end back to the start of the last complete output row.
+    const std::size_t rows = end_pixel / image_.width;
+    const std::size_t first_row = image_.height - rows;
+    const uintptr_t begin = (base + first_row * image_.width * stride + page - 1) / page * page;
+    const uintptr_t end = (base + released_begin_) / page * page;
+    if (end > begin) {
+      madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+      released_begin_ = begin - base;
+    }
+  }
+}
+
+void Converter::write_all(const float* data, std::size_t bytes, off_t offset) {
+  const uint8_t* cursor = reinterpret_cast<const uint8_t*>(data);
+  while (bytes > 0) {
+    const ssize_t written = pwrite(output_fd_, cursor, bytes, offset);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      write_failed_ = true;
+      return;
+    }
+    cursor += written;
+    bytes -= std::size_t(written);
+    offset += written;
+  }
+}
+
+} // namespace tool
+
+} // namespace color
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <color/cache.hpp>
+#include <color/space.hpp>
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace color {
+
+namespace tool {
+
+enum class SampleType { UInt8, UInt16, Float32 };
+
+// The layout of interleaved pixel samples in memory.
+struct Image {
+  std::size_t width;
+  std::size_t height;
+  std::size_t channels;
+  SampleType type;
+  // Multi-byte samples need swapping to the host byte order.
+  bool swap_bytes;
+  // Rows are stored from the bottom of the image up, as in PFM.
+  bool bottom_up;
+  const uint8_t* pixels;
+};
+
+bool host_is_little_endian();
+
+std::size_t sample_size(SampleType type);
+
+// Parse a lowercase space name such as "lab".
+bool parse_space(const char* name, ColorSpace* space);
+
+// Parse the header of a binary PPM (P6), PAM (P7) with three or four channels or PFM (PF) image,
+// pointing the image at the pixels that follow it. On failure, error describes the problem.
+bool parse_image(const uint8_t* data, std::size_t size, Image* image, std::string* error);
+
+// The number of bytes of pixel data in the image. Returns false if the size overflows.
+bool image_bytes(const Image& image, std::size_t* bytes);
+
+// Read one sample, scaling integer samples into [0, 1].
+float read_sample(const uint8_t* data, SampleType type, bool swap_bytes);
+
+// The index of the input pixel written at the given output pixel, where both count from the first
+// stored row. Rows are reversed when only one of the input and output is stored bottom up.
+std::size_t input_pixel(const Image& image, bool output_bottom_up, std::size_t output_pixel);
+
+struct Conversion {
+  ColorSpace from;
+  ColorSpace to;
+  unsigned int threads;
+  bool use_cache;
+};
+
+// Converts an image into interleaved float components written to a file descriptor.
+//
+// The output is produced in fixed-size chunks of pixels in output order, each split across threads,
+// and each finished chunk is written from one of two buffers while the next chunk is converted. The
+// memory used is independent of the image size and shape.
+class Converter {
+public:
+  // The number of pixels converted per chunk, sized so a chunk of output is a few megabytes.
+  static const std::size_t kChunkPixels = 1 << 18;
+
+  // When release_input is set the image pixels must be a memory mapped file, and the pages behind
+  // the conversion are released as it goes so that resident memory stays bounded.
+  Converter(const Image& image, const Conversion& conversion, int output_fd, off_t output_offset,
+            bool output_bottom_up, bool release_input);
+
+  // Convert the whole image, returning false if writing the output fails.
+  bool run();
+
+private:
+  void convert_chunk(std::size_t first_pixel, std::size_t count, float* output);
+  void convert_pixels(std::size_t first_pixel, std::size_t count, float* output,
+                      ConversionCache* cache) const;
+  void release_consumed_input(std::size_t end_pixel);
+  void write_all(const float* data, std::size_t bytes, off_t offset);
+
+  const Image& image_;
+  const Conversion& conversion_;
+  const int output_fd_;
+  const off_t output_offset_;
+  const bool output_bottom_up_;
+  const bool release_input_;
+  std::vector<float> buffers_[2];
+  std::vector<ConversionCache> caches_;
+  // The range of input bytes, relative to the pixels, that has already been released.
+  std::size_t released_begin_;
+  std::size_t released_end_;
+  // Only written by the writer thread, and read after it is joined.
+  bool write_failed_;
+};
+
+} // namespace tool
+
+} // namespace color